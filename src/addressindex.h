@@ -8,6 +8,7 @@
 
 #include "uint256.h"
 #include "amount.h"
+#include "saltedhasher.h"
 
 struct CMempoolAddressDelta
 {
@@ -56,6 +57,15 @@ struct CMempoolAddressDeltaKey
     }
 };
 
+// Hashes (type, addressBytes) pairs
+struct CMempoolAddressHasher
+{
+    std::size_t operator()(const std::pair<int, uint160>& v) const
+    {
+        return CSipHasher(StaticSaltedHasher::s.k0, StaticSaltedHasher::s.k1).Write(v.first).Write(v.second.begin(), v.second.size()).Finalize();
+    }
+};
+
 struct CMempoolAddressDeltaKeyCompare
 {
     bool operator()(const CMempoolAddressDeltaKey& a, const CMempoolAddressDeltaKey& b) const {
@@ -348,6 +348,66 @@ static void BLSVerify_BatchedParallel(benchmark::State& state)
     }
 }
 
+static void BuildPubKeyShareTestVectors(size_t quorumSize, size_t threshold, BLSVerificationVectorPtr& vvec, BLSIdVector& ids)
+{
+    ids.resize(quorumSize);
+    for (size_t i = 0; i < quorumSize; i++) {
+        ids[i].SetInt((int)i + 1);
+    }
+    BLSSecretKeyVector skShares;
+    blsWorker.GenerateContributions((int)threshold, ids, vvec, skShares);
+}
+
+static void BLSBuildPubKeyShares_Single50(benchmark::State& state)
+{
+    BLSVerificationVectorPtr vvec;
+    BLSIdVector ids;
+    BuildPubKeyShareTestVectors(50, 30, vvec, ids);
+
+    // Benchmark.
+    while (state.KeepRunning()) {
+        for (auto& id : ids) {
+            blsWorker.BuildPubKeyShare(vvec, id);
+        }
+    }
+}
+
+static void BLSBuildPubKeyShares_Batched50(benchmark::State& state)
+{
+    BLSVerificationVectorPtr vvec;
+    BLSIdVector ids;
+    BuildPubKeyShareTestVectors(50, 30, vvec, ids);
+
+    // Benchmark.
+    while (state.KeepRunning()) {
+        blsWorker.BuildAllPubKeyShares(vvec, ids);
+    }
+}
+
+static void BLSBuildPubKeyShares_Serial400(benchmark::State& state)
+{
+    BLSVerificationVectorPtr vvec;
+    BLSIdVector ids;
+    BuildPubKeyShareTestVectors(400, 240, vvec, ids);
+
+    // Benchmark.
+    while (state.KeepRunning()) {
+        blsWorker.BuildAllPubKeyShares(vvec, ids, false);
+    }
+}
+
+static void BLSBuildPubKeyShares_Parallel400(benchmark::State& state)
+{
+    BLSVerificationVectorPtr vvec;
+    BLSIdVector ids;
+    BuildPubKeyShareTestVectors(400, 240, vvec, ids);
+
+    // Benchmark.
+    while (state.KeepRunning()) {
+        blsWorker.BuildAllPubKeyShares(vvec, ids, true);
+    }
+}
+
 BENCHMARK(BLSPubKeyAggregate_Normal)
 BENCHMARK(BLSSecKeyAggregate_Normal)
 BENCHMARK(BLSSign_Normal)
@@ -360,3 +420,7 @@ BENCHMARK(BLSVerify_LargeAggregatedBlock10000)
 BENCHMARK(BLSVerify_LargeAggregatedBlock1000PreVerified)
 BENCHMARK(BLSVerify_Batched)
 BENCHMARK(BLSVerify_BatchedParallel)
+BENCHMARK(BLSBuildPubKeyShares_Single50)
+BENCHMARK(BLSBuildPubKeyShares_Batched50)
+BENCHMARK(BLSBuildPubKeyShares_Serial400)
+BENCHMARK(BLSBuildPubKeyShares_Parallel400)
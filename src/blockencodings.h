@@ -8,6 +8,8 @@
 #include "primitives/block.h"
 
 #include <memory>
+#include <set>
+#include <unordered_map>
 
 class CTxMemPool;
 
@@ -148,7 +150,10 @@ public:
     // Dummy for deserialization
     CBlockHeaderAndShortTxIDs() {}
 
-    CBlockHeaderAndShortTxIDs(const CBlock& block);
+    // Prefills the coinbase, all special transactions and the transactions in extraPrefill
+    CBlockHeaderAndShortTxIDs(const CBlock& block, const std::set<uint256>& extraPrefill = {});
+
+    static bool IsAlwaysPrefilled(const CTransaction& tx);
 
     uint64_t GetShortID(const uint256& txhash) const;
 
@@ -194,15 +199,22 @@ public:
 class PartiallyDownloadedBlock {
 protected:
     std::vector<CTransactionRef> txn_available;
-    size_t prefilled_count = 0, mempool_count = 0, extra_count = 0;
+    size_t prefilled_count = 0, mempool_count = 0, extra_count = 0, locked_count = 0;
     CTxMemPool* pool;
+
+    void AddExtraTxn(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& txn,
+                     const std::unordered_map<uint64_t, uint16_t>& shorttxids, std::vector<bool>& have_txn,
+                     std::vector<size_t*>& have_txn_count, size_t& count);
 public:
     CBlockHeader header;
     PartiallyDownloadedBlock(CTxMemPool* poolIn) : pool(poolIn) {}
 
     // extra_txn is a list of extra transactions to look at, in <hash, reference> form
-    ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn);
+    // locked_txn is the same for recently InstantSend locked transactions which might not be in the mempool anymore
+    ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn,
+                        const std::vector<std::pair<uint256, CTransactionRef>>& locked_txn);
     bool IsTxAvailable(size_t index) const;
+    size_t GetLockedTxCount() const { return locked_count; }
     ReadStatus FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing);
 };
 
@@ -723,6 +723,37 @@ CBLSPublicKey CBLSWorker::BuildPubKeyShare(const BLSVerificationVectorPtr& vvec,
     return pkShare;
 }
 
+BLSPublicKeyVector CBLSWorker::BuildAllPubKeyShares(const BLSVerificationVectorPtr& vvec, const BLSIdVector& ids, bool parallel)
+{
+    BLSPublicKeyVector pkShares(ids.size());
+
+    if (!parallel) {
+        for (size_t i = 0; i < ids.size(); i++) {
+            pkShares[i].PublicKeyShare(*vvec, ids[i]);
+        }
+        return pkShares;
+    }
+
+    std::list<std::future<bool> > futures;
+    size_t batchSize = 8;
+
+    for (size_t i = 0; i < ids.size(); i += batchSize) {
+        size_t start = i;
+        size_t count = std::min(batchSize, ids.size() - start);
+        auto f = [&, start, count](int threadId) {
+            for (size_t j = start; j < start + count; j++) {
+                pkShares[j].PublicKeyShare(*vvec, ids[j]);
+            }
+            return true;
+        };
+        futures.emplace_back(workerPool.push(f));
+    }
+    for (auto& f : futures) {
+        f.get();
+    }
+    return pkShares;
+}
+
 void CBLSWorker::AsyncVerifyContributionShares(const CBLSId& forId, const std::vector<BLSVerificationVectorPtr>& vvecs, const BLSSecretKeyVector& skShares,
                                                bool parallel, bool aggregated, std::function<void(const std::vector<bool>&)> doneCallback)
 {
@@ -8,6 +8,8 @@
 #include "bls.h"
 
 #include "ctpl.h"
+#include "saltedhasher.h"
+#include "unordered_lru_cache.h"
 
 #include <future>
 #include <mutex>
@@ -108,6 +110,10 @@ public:
     // Calculate public key share from public key vector and id. Not parallelized
     CBLSPublicKey BuildPubKeyShare(const BLSVerificationVectorPtr& vvec, const CBLSId& id);
 
+    // Calculate public key shares for all ids from the same public key vector. The ids are split into batches which are
+    // calculated in parallel. Shares for which the calculation failed are left invalid
+    BLSPublicKeyVector BuildAllPubKeyShares(const BLSVerificationVectorPtr& vvec, const BLSIdVector& ids, bool parallel = true);
+
     // The following functions verify multiple verification vectors and contributions for the same id
     // This is parallelized by performing batched verification. The verification vectors and the contributions of
     // a batch are aggregated (in parallel, see AsyncBuildQuorumVerificationVector and AsyncBuildSecretKeyShare). The
@@ -147,19 +153,30 @@ private:
 // Cache keys are provided externally as computing hashes on BLS vectors is too expensive
 // If multiple threads try to build the same thing at the same time, only one will actually build it
 // and the other ones will wait for the result of the first caller
+// Each of the caches is bounded and evicts the least recently used entries when it grows too large. Evicting an entry
+// that is still being built is fine, as the builder and all waiting callers hold their own reference to the shared future
 class CBLSWorkerCache
 {
+public:
+    static const size_t DEFAULT_MAX_CACHE_SIZE = 1000;
+
 private:
+    template <typename T>
+    using CacheType = unordered_lru_cache<uint256, std::shared_future<T>, StaticSaltedHasher>;
+
     CBLSWorker& worker;
 
     std::mutex cacheCs;
-    std::map<uint256, std::shared_future<BLSVerificationVectorPtr> > vvecCache;
-    std::map<uint256, std::shared_future<CBLSSecretKey> > secretKeyShareCache;
-    std::map<uint256, std::shared_future<CBLSPublicKey> > publicKeyShareCache;
+    CacheType<BLSVerificationVectorPtr> vvecCache;
+    CacheType<CBLSSecretKey> secretKeyShareCache;
+    CacheType<CBLSPublicKey> publicKeyShareCache;
 
 public:
-    CBLSWorkerCache(CBLSWorker& _worker) :
-        worker(_worker) {}
+    CBLSWorkerCache(CBLSWorker& _worker, size_t _maxCacheSize = DEFAULT_MAX_CACHE_SIZE) :
+        worker(_worker),
+        vvecCache(_maxCacheSize),
+        secretKeyShareCache(_maxCacheSize),
+        publicKeyShareCache(_maxCacheSize) {}
 
     BLSVerificationVectorPtr BuildQuorumVerificationVector(const uint256& cacheKey, const std::vector<BLSVerificationVectorPtr>& vvecs)
     {
@@ -182,18 +199,17 @@ public:
 
 private:
     template <typename T, typename Builder>
-    T GetOrBuild(const uint256& cacheKey, std::map<uint256, std::shared_future<T> >& cache, Builder&& builder)
+    T GetOrBuild(const uint256& cacheKey, CacheType<T>& cache, Builder&& builder)
     {
         cacheCs.lock();
-        auto it = cache.find(cacheKey);
-        if (it != cache.end()) {
-            auto f = it->second;
+        std::shared_future<T> f;
+        if (cache.get(cacheKey, f)) {
             cacheCs.unlock();
             return f.get();
         }
 
         std::promise<T> p;
-        cache.emplace(cacheKey, p.get_future());
+        cache.insert(cacheKey, p.get_future());
         cacheCs.unlock();
 
         T v = builder();
@@ -142,6 +142,7 @@ public:
     bool Valid();
 
     void SeekToFirst();
+    void SeekToLast();
 
     template<typename K> void Seek(const K& key) {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
@@ -156,6 +157,7 @@ public:
     }
 
     void Next();
+    void Prev();
 
     template<typename K> bool GetKey(K& key) {
         try {
@@ -194,6 +196,20 @@ public:
 
 };
 
+/** LevelDB options which can be tuned per database */
+struct CDBTuningOptions
+{
+    //! bits per key used by the bloom filter, 0 disables the filter
+    int nBloomBits{10};
+    //! approximate size of (uncompressed) user data packed per block
+    size_t nBlockSize{4096};
+    //! compress blocks with snappy, if leveldb was built with it
+    bool fCompression{false};
+
+    /** Overrides the values with -<name>bloombits, -<name>blocksize and -<name>compression, if set */
+    void ApplyArgs(const std::string& name);
+};
+
 class CDBWrapper
 {
     friend const std::vector<unsigned char>& dbwrapper_private::GetObfuscateKey(const CDBWrapper &w);
@@ -238,8 +254,10 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] tuning      Bloom filter, block size and compression options.
      */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false,
+               const CDBTuningOptions& tuning = CDBTuningOptions());
     ~CDBWrapper();
 
     template <typename K>
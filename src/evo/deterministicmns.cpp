@@ -18,6 +18,9 @@
 
 #include <univalue.h>
 
+#include <iterator>
+#include <set>
+
 static const std::string DB_LIST_SNAPSHOT = "dmn_S";
 static const std::string DB_LIST_DIFF = "dmn_D";
 
@@ -208,41 +211,47 @@ static bool CompareByLastPaid(const CDeterministicMNCPtr& _a, const CDeterminist
     return CompareByLastPaid(*_a, *_b);
 }
 
+std::shared_ptr<const std::vector<CDeterministicMNCPtr>> CDeterministicMNList::GetPayeeQueue() const
+{
+    LOCK(payeeQueue->cs);
+    if (!payeeQueue->vQueue) {
+        auto vQueue = std::make_shared<std::vector<CDeterministicMNCPtr>>();
+        vQueue->reserve(mnMap.size());
+        ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
+            vQueue->emplace_back(dmn);
+        });
+        std::sort(vQueue->begin(), vQueue->end(), [](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
+            return CompareByLastPaid(a, b);
+        });
+        payeeQueue->vQueue = std::move(vQueue);
+    }
+    return payeeQueue->vQueue;
+}
+
 CDeterministicMNCPtr CDeterministicMNList::GetMNPayee() const
 {
     if (mnMap.size() == 0) {
         return nullptr;
     }
 
-    CDeterministicMNCPtr best;
-    ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
-        if (!best || CompareByLastPaid(dmn, best)) {
-            best = dmn;
-        }
-    });
-
-    return best;
+    auto vQueue = GetPayeeQueue();
+    if (vQueue->empty()) {
+        return nullptr;
+    }
+    return vQueue->front();
 }
 
 std::vector<CDeterministicMNCPtr> CDeterministicMNList::GetProjectedMNPayees(int nCount) const
 {
-    if (nCount > GetValidMNsCount()) {
-        nCount = GetValidMNsCount();
+    auto vQueue = GetPayeeQueue();
+    if (nCount < 0) {
+        nCount = 0;
+    }
+    if (nCount > (int)vQueue->size()) {
+        nCount = (int)vQueue->size();
     }
 
-    std::vector<CDeterministicMNCPtr> result;
-    result.reserve(nCount);
-
-    ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
-        result.emplace_back(dmn);
-    });
-    std::sort(result.begin(), result.end(), [&](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
-        return CompareByLastPaid(a, b);
-    });
-
-    result.resize(nCount);
-
-    return result;
+    return std::vector<CDeterministicMNCPtr>(vQueue->begin(), vQueue->begin() + nCount);
 }
 
 std::vector<CDeterministicMNCPtr> CDeterministicMNList::CalculateQuorum(size_t maxSize, const uint256& modifier) const
@@ -411,6 +420,12 @@ CDeterministicMNList CDeterministicMNList::ApplyDiff(const CBlockIndex* pindex,
     result.blockHash = pindex->GetBlockHash();
     result.nHeight = pindex->nHeight;
 
+    std::shared_ptr<const std::vector<CDeterministicMNCPtr>> oldQueue;
+    {
+        LOCK(payeeQueue->cs);
+        oldQueue = payeeQueue->vQueue;
+    }
+
     for (const auto& id : diff.removedMns) {
         auto dmn = result.GetMNByInternalId(id);
         assert(dmn);
@@ -426,12 +441,52 @@ CDeterministicMNList CDeterministicMNList::ApplyDiff(const CBlockIndex* pindex,
         result.UpdateMN(dmn, p.second);
     }
 
+    if (oldQueue && result.payeeQueue != payeeQueue) {
+        // Only the MNs touched by the diff can change their position, so drop them from the old queue and merge them
+        // back in with their new state instead of sorting the whole list again
+        std::set<uint64_t> changedIds(diff.removedMns.begin(), diff.removedMns.end());
+        std::vector<CDeterministicMNCPtr> vChanged;
+        for (const auto& dmn : diff.addedMNs) {
+            changedIds.emplace(dmn->internalId);
+        }
+        for (const auto& p : diff.updatedMNs) {
+            changedIds.emplace(p.first);
+        }
+        for (const auto& id : changedIds) {
+            auto dmn = result.GetMNByInternalId(id);
+            if (dmn && result.IsMNValid(dmn)) {
+                vChanged.emplace_back(dmn);
+            }
+        }
+        std::sort(vChanged.begin(), vChanged.end(), [](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
+            return CompareByLastPaid(a, b);
+        });
+
+        std::vector<CDeterministicMNCPtr> vUnchanged;
+        vUnchanged.reserve(oldQueue->size());
+        for (const auto& dmn : *oldQueue) {
+            if (!changedIds.count(dmn->internalId)) {
+                vUnchanged.emplace_back(dmn);
+            }
+        }
+
+        auto vQueue = std::make_shared<std::vector<CDeterministicMNCPtr>>();
+        vQueue->reserve(vUnchanged.size() + vChanged.size());
+        std::merge(vUnchanged.begin(), vUnchanged.end(), vChanged.begin(), vChanged.end(), std::back_inserter(*vQueue),
+            [](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
+                return CompareByLastPaid(a, b);
+            });
+        LOCK(result.payeeQueue->cs);
+        result.payeeQueue->vQueue = std::move(vQueue);
+    }
+
     return result;
 }
 
 void CDeterministicMNList::AddMN(const CDeterministicMNCPtr& dmn)
 {
     assert(!mnMap.find(dmn->proTxHash));
+    InvalidatePayeeQueue();
     mnMap = mnMap.set(dmn->proTxHash, dmn);
     mnInternalIdMap = mnInternalIdMap.set(dmn->internalId, dmn->proTxHash);
     AddUniqueProperty(dmn, dmn->collateralOutpoint);
@@ -450,6 +505,7 @@ void CDeterministicMNList::UpdateMN(const CDeterministicMNCPtr& oldDmn, const CD
     auto dmn = std::make_shared<CDeterministicMN>(*oldDmn);
     auto oldState = dmn->pdmnState;
     dmn->pdmnState = pdmnState;
+    InvalidatePayeeQueue();
     mnMap = mnMap.set(oldDmn->proTxHash, dmn);
 
     UpdateUniqueProperty(dmn, oldState->addr, pdmnState->addr);
@@ -485,6 +541,7 @@ void CDeterministicMNList::RemoveMN(const uint256& proTxHash)
     if (dmn->pdmnState->pubKeyOperator.Get().IsValid()) {
         DeleteUniqueProperty(dmn, dmn->pdmnState->pubKeyOperator);
     }
+    InvalidatePayeeQueue();
     mnMap = mnMap.erase(proTxHash);
     mnInternalIdMap = mnInternalIdMap.erase(dmn->internalId);
 }
@@ -287,6 +287,14 @@ private:
     // we keep track of this as checking for duplicates would otherwise be painfully slow
     MnUniquePropertyMap mnUniquePropertyMap;
 
+    // valid MNs ordered by payment priority, built on first use and shared between copies of the list until one of
+    // them is modified. ApplyDiff updates it incrementally if the list it's applied to already had one
+    struct CPayeeQueue {
+        CCriticalSection cs;
+        std::shared_ptr<const std::vector<CDeterministicMNCPtr>> vQueue;
+    };
+    std::shared_ptr<CPayeeQueue> payeeQueue{std::make_shared<CPayeeQueue>()};
+
 public:
     CDeterministicMNList() {}
     explicit CDeterministicMNList(const uint256& _blockHash, int _height, uint32_t _totalRegisteredCount) :
@@ -320,6 +328,7 @@ public:
         mnMap = MnMap();
         mnUniquePropertyMap = MnUniquePropertyMap();
         mnInternalIdMap = MnInternalIdMap();
+        payeeQueue = std::make_shared<CPayeeQueue>();
 
         SerializationOpBase(s, CSerActionUnserialize());
 
@@ -484,6 +493,12 @@ public:
     }
 
 private:
+    std::shared_ptr<const std::vector<CDeterministicMNCPtr>> GetPayeeQueue() const;
+    void InvalidatePayeeQueue()
+    {
+        payeeQueue = std::make_shared<CPayeeQueue>();
+    }
+
     template <typename T>
     void AddUniqueProperty(const CDeterministicMNCPtr& dmn, const T& v)
     {
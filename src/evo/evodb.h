@@ -13,6 +13,9 @@
 // "b_b2" was used after compact diffs were introduced
 static const std::string EVODB_BEST_BLOCK = "b_b2";
 
+//! -evodbcache default (MiB)
+static const int64_t nDefaultEvoDbCache = 16;
+
 class CEvoDB;
 
 class CEvoDBScopedCommitter
@@ -43,6 +46,7 @@ private:
     CurTransaction curDBTransaction;
 
 public:
+    // LevelDB options can be tuned with -evodbbloombits, -evodbblocksize and -evodbcompression
     CEvoDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
     std::unique_ptr<CEvoDBScopedCommitter> BeginTransaction()
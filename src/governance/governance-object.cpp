@@ -93,6 +93,8 @@ CGovernanceObject::CGovernanceObject(const CGovernanceObject& other) :
     fExpired(other.fExpired),
     fUnparsable(other.fUnparsable),
     mapCurrentMNVotes(other.mapCurrentMNVotes),
+    mapVoteTally(other.mapVoteTally),
+    fVoteTallyInvalid(other.fVoteTallyInvalid),
     fileVotes(other.fileVotes)
 {
 }
@@ -100,7 +102,8 @@ CGovernanceObject::CGovernanceObject(const CGovernanceObject& other) :
 bool CGovernanceObject::ProcessVote(CNode* pfrom,
     const CGovernanceVote& vote,
     CGovernanceException& exception,
-    CConnman& connman)
+    CConnman& connman,
+    bool fSigChecked)
 {
     LOCK(cs);
 
@@ -188,7 +191,7 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
     bool onlyVotingKeyAllowed = nObjectType == GOVERNANCE_OBJECT_PROPOSAL && vote.GetSignal() == VOTE_SIGNAL_FUNDING;
 
     // Finally check that the vote is actually valid (done last because of cost of signature verification)
-    if (!vote.IsValid(onlyVotingKeyAllowed)) {
+    if (!vote.IsValid(onlyVotingKeyAllowed, fSigChecked)) {
         std::ostringstream ostr;
         ostr << "CGovernanceObject::ProcessVote -- Invalid vote"
              << ", MN outpoint = " << vote.GetMasternodeOutpoint().ToStringShort()
@@ -210,6 +213,8 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
         return false;
     }
 
+    UpdateVoteTally(eSignal, voteInstanceRef.eOutcome, -1);
+    UpdateVoteTally(eSignal, vote.GetOutcome(), 1);
     voteInstanceRef = vote_instance_t(vote.GetOutcome(), nVoteTimeUpdate, vote.GetTimestamp());
     fileVotes.AddVote(vote);
     fDirtyCache = true;
@@ -225,6 +230,9 @@ void CGovernanceObject::ClearMasternodeVotes()
     vote_m_it it = mapCurrentMNVotes.begin();
     while (it != mapCurrentMNVotes.end()) {
         if (!mnList.HasMNByCollateral(it->first)) {
+            for (const auto& p : it->second.mapInstances) {
+                UpdateVoteTally(p.first, p.second.eOutcome, -1);
+            }
             fileVotes.RemoveVotesFromMasternode(it->first);
             mapCurrentMNVotes.erase(it++);
             fDirtyCache = true;
@@ -254,6 +262,7 @@ std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const COutPoint& mnOutpo
         CGovernanceVote tmpVote(mnOutpoint, nParentHash, (vote_signal_enum_t)jt->first, jt->second.eOutcome);
         tmpVote.SetTime(jt->second.nCreationTime);
         if (removedVotes.count(tmpVote.GetHash())) {
+            UpdateVoteTally(jt->first, jt->second.eOutcome, -1);
             jt = it->second.mapInstances.erase(jt);
         } else {
             ++jt;
@@ -591,10 +600,49 @@ bool CGovernanceObject::IsCollateralValid(std::string& strError, bool& fMissingC
     return true;
 }
 
+void CGovernanceObject::UpdateVoteTally(int nSignal, vote_outcome_enum_t eOutcome, int nDelta) const
+{
+    // VOTE_OUTCOME_NONE is the outcome of placeholder records, it's not tallied
+    if (eOutcome <= VOTE_OUTCOME_NONE || eOutcome > VOTE_OUTCOME_ABSTAIN) {
+        return;
+    }
+    auto it = mapVoteTally.emplace(nSignal, std::array<int, VOTE_OUTCOME_ABSTAIN + 1>{}).first;
+    it->second[eOutcome] += nDelta;
+    if (it->second[eOutcome] < 0) {
+        // Should never happen, but this is reachable from the network, so don't crash. The tally is not rebuilt here
+        // as the caller might be in the middle of updating mapCurrentMNVotes.
+        LogPrintf("CGovernanceObject::%s -- negative vote tally for %s, signal=%d, outcome=%d, rebuilding\n",
+                  __func__, GetHash().ToString(), nSignal, eOutcome);
+        it->second[eOutcome] = 0;
+        fVoteTallyInvalid = true;
+    }
+}
+
+void CGovernanceObject::RebuildVoteTally() const
+{
+    LOCK(cs);
+
+    mapVoteTally.clear();
+    fVoteTallyInvalid = false;
+    for (const auto& votepair : mapCurrentMNVotes) {
+        for (const auto& p : votepair.second.mapInstances) {
+            UpdateVoteTally(p.first, p.second.eOutcome, 1);
+        }
+    }
+}
+
 int CGovernanceObject::CountMatchingVotes(vote_signal_enum_t eVoteSignalIn, vote_outcome_enum_t eVoteOutcomeIn) const
 {
     LOCK(cs);
 
+    if (eVoteOutcomeIn > VOTE_OUTCOME_NONE && eVoteOutcomeIn <= VOTE_OUTCOME_ABSTAIN) {
+        if (fVoteTallyInvalid) {
+            RebuildVoteTally();
+        }
+        auto it = mapVoteTally.find(eVoteSignalIn);
+        return it != mapVoteTally.end() ? it->second[eVoteOutcomeIn] : 0;
+    }
+
     int nCount = 0;
     for (const auto& votepair : mapCurrentMNVotes) {
         const vote_rec_t& recVote = votepair.second;
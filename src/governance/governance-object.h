@@ -18,6 +18,8 @@
 
 #include <univalue.h>
 
+#include <array>
+
 class CGovernanceManager;
 class CGovernanceTriggerManager;
 class CGovernanceObject;
@@ -26,6 +28,7 @@ class CGovernanceVote;
 static const int MIN_GOVERNANCE_PEER_PROTO_VERSION = 70213;
 static const int GOVERNANCE_FILTER_PROTO_VERSION = 70206;
 static const int GOVERNANCE_POSE_BANNED_VOTES_VERSION = 70215;
+static const int GOVERNANCE_RECONCILIATION_PROTO_VERSION = 70217;
 
 static const double GOVERNANCE_FILTER_FP_RATE = 0.001;
 
@@ -175,6 +178,11 @@ private:
 
     vote_m_t mapCurrentMNVotes;
 
+    /// Memory only, number of current votes per signal and outcome, kept in sync with mapCurrentMNVotes
+    mutable std::map<int, std::array<int, VOTE_OUTCOME_ABSTAIN + 1>> mapVoteTally;
+    /// Memory only, set when mapVoteTally went out of sync, it is then rebuilt on the next CountMatchingVotes call
+    mutable bool fVoteTallyInvalid{false};
+
     CGovernanceObjectVoteFile fileVotes;
 
 public:
@@ -330,12 +338,20 @@ public:
             READWRITE(fExpired);
             READWRITE(mapCurrentMNVotes);
             READWRITE(fileVotes);
+            if (ser_action.ForRead()) {
+                RebuildVoteTally();
+            }
             LogPrint(BCLog::GOBJECT, "CGovernanceObject::SerializationOp hash = %s, vote count = %d\n", GetHash().ToString(), fileVotes.GetVoteCount());
         }
 
         // AFTER DESERIALIZATION OCCURS, CACHED VARIABLES MUST BE CALCULATED MANUALLY
     }
 
+private:
+    void UpdateVoteTally(int nSignal, vote_outcome_enum_t eOutcome, int nDelta) const;
+    void RebuildVoteTally() const;
+
+public:
     // FUNCTIONS FOR DEALING WITH DATA STRING
     void LoadData();
     void GetData(UniValue& objResult);
@@ -343,7 +359,8 @@ public:
     bool ProcessVote(CNode* pfrom,
         const CGovernanceVote& vote,
         CGovernanceException& exception,
-        CConnman& connman);
+        CConnman& connman,
+        bool fSigChecked = false);
 
     /// Called when MN's which have voted on this object have been removed
     void ClearMasternodeVotes();
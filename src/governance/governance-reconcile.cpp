@@ -0,0 +1,54 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "governance-reconcile.h"
+
+#include "crypto/common.h"
+
+#include <assert.h>
+
+constexpr uint8_t CGovernanceReconSketch::MAX_BUCKET_BITS;
+constexpr size_t CGovernanceReconSketch::ITEMS_PER_BUCKET;
+
+CGovernanceReconSketch::CGovernanceReconSketch(uint8_t _nBucketBits) :
+    nBucketBits(_nBucketBits),
+    vChecksums(_nBucketBits <= MAX_BUCKET_BITS ? ((size_t)1 << _nBucketBits) : 0, 0)
+{
+}
+
+uint8_t CGovernanceReconSketch::CalcBucketBits(size_t nItems)
+{
+    uint8_t nBits = 0;
+    while (nBits < MAX_BUCKET_BITS && ((size_t)1 << nBits) * ITEMS_PER_BUCKET < nItems) {
+        nBits++;
+    }
+    return nBits;
+}
+
+size_t CGovernanceReconSketch::GetBucket(const uint256& nHash) const
+{
+    return nHash.GetCheapHash() & (((uint64_t)1 << nBucketBits) - 1);
+}
+
+bool CGovernanceReconSketch::IsValid() const
+{
+    return nBucketBits <= MAX_BUCKET_BITS && vChecksums.size() == ((size_t)1 << nBucketBits);
+}
+
+void CGovernanceReconSketch::Insert(const uint256& nHash)
+{
+    // the low bits of the first word are the same for all hashes of a bucket, so use the second word as checksum
+    vChecksums[GetBucket(nHash)] ^= ReadLE64(nHash.begin() + 8);
+}
+
+std::vector<bool> CGovernanceReconSketch::GetDifferingBuckets(const CGovernanceReconSketch& other) const
+{
+    assert(nBucketBits == other.nBucketBits && IsValid() && other.IsValid());
+
+    std::vector<bool> ret(vChecksums.size());
+    for (size_t i = 0; i < vChecksums.size(); i++) {
+        ret[i] = vChecksums[i] != other.vChecksums[i];
+    }
+    return ret;
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GOVERNANCE_RECONCILE_H
+#define GOVERNANCE_RECONCILE_H
+
+#include "serialize.h"
+#include "uint256.h"
+
+#include <vector>
+
+/**
+ * Compact summary of a set of governance object or vote hashes, used to reconcile the sets of two peers.
+ *
+ * Hashes are assigned to 2^nBucketBits buckets and each bucket stores the XOR of the hashes in it. The requesting
+ * node sends the sketch of what it already has and the peer only announces the items of the buckets in which its own
+ * sketch differs, so that peers which are mostly in sync only exchange a few buckets instead of the full set.
+ */
+class CGovernanceReconSketch
+{
+public:
+    static constexpr uint8_t MAX_BUCKET_BITS = 12;
+    // the requester aims for this many items per bucket
+    static constexpr size_t ITEMS_PER_BUCKET = 4;
+
+private:
+    uint8_t nBucketBits;
+    std::vector<uint64_t> vChecksums;
+
+public:
+    explicit CGovernanceReconSketch(uint8_t _nBucketBits = 0);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nBucketBits);
+        READWRITE(vChecksums);
+    }
+
+    static uint8_t CalcBucketBits(size_t nItems);
+
+    uint8_t GetBucketBits() const { return nBucketBits; }
+    size_t GetBucket(const uint256& nHash) const;
+    bool IsValid() const;
+
+    void Insert(const uint256& nHash);
+
+    // Returns for each bucket whether it differs between this and other, both must use the same number of buckets
+    std::vector<bool> GetDifferingBuckets(const CGovernanceReconSketch& other) const;
+};
+
+#endif
@@ -99,11 +99,14 @@ public:
     bool CheckSignature(const CKeyID& keyID) const;
     bool Sign(const CBLSSecretKey& key);
     bool CheckSignature(const CBLSPublicKey& pubKey) const;
-    bool IsValid(bool useVotingKey) const;
+    // If fSigChecked is set, the signature was already verified by the caller
+    bool IsValid(bool useVotingKey, bool fSigChecked = false) const;
     void Relay(CConnman& connman) const;
 
     const COutPoint& GetMasternodeOutpoint() const { return masternodeOutpoint; }
 
+    const std::vector<unsigned char>& GetSignature() const { return vchSig; }
+
     /**
     *   GetHash()
     *
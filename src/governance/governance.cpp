@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "governance.h"
+#include "checkqueue.h"
 #include "consensus/validation.h"
 #include "governance-classes.h"
 #include "governance-object.h"
@@ -20,8 +21,49 @@
 #include "validation.h"
 #include "validationinterface.h"
 
+#include "bls/bls_batchverifier.h"
+
 CGovernanceManager governance;
 
+/**
+ * Closure representing the voting key signature check of a single governance vote. The result is reported through
+ * fValidRet and the check itself always succeeds, so that the queue continues after an invalid signature and the
+ * offending peers can be identified.
+ */
+class CGovernanceVoteSigCheck
+{
+private:
+    const CGovernanceVote* vote{nullptr};
+    CKeyID keyID;
+    bool* fValidRet{nullptr};
+
+public:
+    CGovernanceVoteSigCheck() {}
+    CGovernanceVoteSigCheck(const CGovernanceVote& _vote, const CKeyID& _keyID, bool& _fValidRet) :
+        vote(&_vote), keyID(_keyID), fValidRet(&_fValidRet) {}
+
+    bool operator()()
+    {
+        *fValidRet = vote->CheckSignature(keyID);
+        return true;
+    }
+
+    void swap(CGovernanceVoteSigCheck& check)
+    {
+        std::swap(vote, check.vote);
+        std::swap(keyID, check.keyID);
+        std::swap(fValidRet, check.fValidRet);
+    }
+};
+
+static CCheckQueue<CGovernanceVoteSigCheck> govvotecheckqueue(128);
+
+void ThreadGovernanceVoteCheck()
+{
+    RenameThread("dash-govvotech");
+    govvotecheckqueue.Thread();
+}
+
 int nSubmittedFinalBudget;
 
 const std::string CGovernanceManager::SERIALIZATION_VERSION_STRING = "CGovernanceManager-Version-15";
@@ -124,6 +166,36 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
         LogPrint(BCLog::GOBJECT, "MNGOVERNANCESYNC -- syncing governance objects to our peer %s\n", pfrom->GetLogString());
     }
 
+    // SAME AS MNGOVERNANCESYNC, BUT THE PEER TOLD US WHAT IT ALREADY HAS
+    else if (strCommand == NetMsgType::MNGOVERNANCERECON) {
+        if (pfrom->nVersion < GOVERNANCE_RECONCILIATION_PROTO_VERSION) {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), 10);
+            return;
+        }
+
+        if (!masternodeSync.IsSynced()) return;
+
+        uint256 nProp;
+        CGovernanceReconSketch sketch;
+        vRecv >> nProp >> sketch;
+
+        if (!sketch.IsValid()) {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), 100);
+            return;
+        }
+
+        if (nProp == uint256()) {
+            SyncObjects(pfrom, connman, &sketch);
+        } else {
+            CBloomFilter filter;
+            filter.clear();
+            SyncSingleObjVotes(pfrom, nProp, filter, connman, &sketch);
+        }
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCERECON -- reconciling governance objects with our peer %s, nBucketBits=%d\n", pfrom->GetLogString(), sketch.GetBucketBits());
+    }
+
     // A NEW GOVERNANCE OBJECT HAS ARRIVED
     else if (strCommand == NetMsgType::MNGOVERNANCEOBJECT) {
         // MAKE SURE WE HAVE A VALID REFERENCE TO THE TIP BEFORE CONTINUING
@@ -234,6 +306,21 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
             return;
         }
 
+        {
+            LOCK(cs);
+            // Votes for known objects are verified in batches by ProcessPendingVotes. Everything else is either cheap
+            // to reject or ends up as orphan vote, so it's handled right away, same as votes above the queue limits.
+            auto itPeer = mapPendingVotesPerPeer.find(pfrom->GetId());
+            size_t nPeerPending = itPeer != mapPendingVotesPerPeer.end() ? itPeer->second : 0;
+            if (mapObjects.count(vote.GetParentHash()) && !cmapVoteToObject.HasKey(nHash) && !cmapInvalidVotes.HasKey(nHash) &&
+                    mapPendingVotes.size() < MAX_PENDING_VOTES && nPeerPending < MAX_PENDING_VOTES_PER_PEER) {
+                if (mapPendingVotes.emplace(nHash, std::make_pair(pfrom->GetId(), vote)).second) {
+                    mapPendingVotesPerPeer[pfrom->GetId()]++;
+                }
+                return;
+            }
+        }
+
         CGovernanceException exception;
         if (ProcessVote(pfrom, vote, exception, connman)) {
             LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- %s new\n", strHash);
@@ -567,7 +654,7 @@ bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
         break;
     } 
     case MSG_GOVERNANCE_OBJECT_VOTE: {
-        if (cmapVoteToObject.HasKey(inv.hash)) {
+        if (cmapVoteToObject.HasKey(inv.hash) || mapPendingVotes.count(inv.hash)) {
             LogPrint(BCLog::GOBJECT, "CGovernanceManager::ConfirmInventoryRequest already have governance vote, returning false\n");
             return false;
         }
@@ -601,7 +688,7 @@ bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
     return true;
 }
 
-void CGovernanceManager::SyncSingleObjVotes(CNode* pnode, const uint256& nProp, const CBloomFilter& filter, CConnman& connman)
+void CGovernanceManager::SyncSingleObjVotes(CNode* pnode, const uint256& nProp, const CBloomFilter& filter, CConnman& connman, const CGovernanceReconSketch* pSketch)
 {
     // do not provide any data until our node is synced
     if (!masternodeSync.IsSynced()) return;
@@ -633,6 +720,7 @@ void CGovernanceManager::SyncSingleObjVotes(CNode* pnode, const uint256& nProp,
 
     auto fileVotes = govobj.GetVoteFile();
 
+    std::vector<uint256> vecVoteHashes;
     for (const auto& vote : fileVotes.GetVotes()) {
         uint256 nVoteHash = vote.GetHash();
 
@@ -641,6 +729,14 @@ void CGovernanceManager::SyncSingleObjVotes(CNode* pnode, const uint256& nProp,
         if (filter.contains(nVoteHash) || !vote.IsValid(onlyVotingKeyAllowed)) {
             continue;
         }
+        vecVoteHashes.emplace_back(nVoteHash);
+    }
+
+    if (pSketch) {
+        FilterReconciledHashes(vecVoteHashes, *pSketch);
+    }
+
+    for (const auto& nVoteHash : vecVoteHashes) {
         pnode->PushInventory(CInv(MSG_GOVERNANCE_OBJECT_VOTE, nVoteHash));
         ++nVoteCount;
     }
@@ -650,7 +746,7 @@ void CGovernanceManager::SyncSingleObjVotes(CNode* pnode, const uint256& nProp,
     LogPrintf("CGovernanceManager::%s -- sent %d votes to peer=%d\n", __func__, nVoteCount, pnode->GetId());
 }
 
-void CGovernanceManager::SyncObjects(CNode* pnode, CConnman& connman) const
+void CGovernanceManager::SyncObjects(CNode* pnode, CConnman& connman, const CGovernanceReconSketch* pSketch) const
 {
     // do not provide any data until our node is synced
     if (!masternodeSync.IsSynced()) return;
@@ -673,6 +769,7 @@ void CGovernanceManager::SyncObjects(CNode* pnode, CConnman& connman) const
     LOCK2(cs_main, cs);
 
     // all valid objects, no votes
+    std::vector<uint256> vecObjHashes;
     for (const auto& objPair : mapObjects) {
         uint256 nHash = objPair.first;
         const CGovernanceObject& govobj = objPair.second;
@@ -686,8 +783,16 @@ void CGovernanceManager::SyncObjects(CNode* pnode, CConnman& connman) const
             continue;
         }
 
+        vecObjHashes.emplace_back(nHash);
+    }
+
+    if (pSketch) {
+        FilterReconciledHashes(vecObjHashes, *pSketch);
+    }
+
+    for (const auto& nHash : vecObjHashes) {
         // Push the inventory budget proposal message over to the other client
-        LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- syncing govobj: %s, peer=%d\n", __func__, strHash, pnode->GetId());
+        LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- syncing govobj: %s, peer=%d\n", __func__, nHash.ToString(), pnode->GetId());
         pnode->PushInventory(CInv(MSG_GOVERNANCE_OBJECT, nHash));
         ++nObjCount;
     }
@@ -697,6 +802,61 @@ void CGovernanceManager::SyncObjects(CNode* pnode, CConnman& connman) const
     LogPrintf("CGovernanceManager::%s -- sent %d objects to peer=%d\n", __func__, nObjCount, pnode->GetId());
 }
 
+void CGovernanceManager::FilterReconciledHashes(std::vector<uint256>& vecHashes, const CGovernanceReconSketch& peerSketch)
+{
+    CGovernanceReconSketch sketch(peerSketch.GetBucketBits());
+    for (const auto& nHash : vecHashes) {
+        sketch.Insert(nHash);
+    }
+    auto vecDiffering = sketch.GetDifferingBuckets(peerSketch);
+
+    // only keep the items of buckets in which the peer has something different
+    size_t nOldSize = vecHashes.size();
+    vecHashes.erase(std::remove_if(vecHashes.begin(), vecHashes.end(), [&](const uint256& nHash) {
+        return !vecDiffering[sketch.GetBucket(nHash)];
+    }), vecHashes.end());
+
+    LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- %d of %d items in differing buckets\n", __func__, vecHashes.size(), nOldSize);
+}
+
+CGovernanceReconSketch CGovernanceManager::GetObjectsReconSketch() const
+{
+    LOCK(cs);
+
+    // must match the objects which are announced by SyncObjects
+    std::vector<uint256> vecObjHashes;
+    for (const auto& objPair : mapObjects) {
+        const CGovernanceObject& govobj = objPair.second;
+        if (govobj.IsSetCachedDelete() || govobj.IsSetExpired()) {
+            continue;
+        }
+        vecObjHashes.emplace_back(objPair.first);
+    }
+
+    CGovernanceReconSketch sketch(CGovernanceReconSketch::CalcBucketBits(vecObjHashes.size()));
+    for (const auto& nHash : vecObjHashes) {
+        sketch.Insert(nHash);
+    }
+    return sketch;
+}
+
+CGovernanceReconSketch CGovernanceManager::GetVotesReconSketch(const uint256& nProp) const
+{
+    LOCK(cs);
+
+    auto it = mapObjects.find(nProp);
+    if (it == mapObjects.end()) {
+        return CGovernanceReconSketch();
+    }
+
+    std::vector<CGovernanceVote> vecVotes = it->second.GetVoteFile().GetVotes();
+    CGovernanceReconSketch sketch(CGovernanceReconSketch::CalcBucketBits(vecVotes.size()));
+    for (const auto& vote : vecVotes) {
+        sketch.Insert(vote.GetHash());
+    }
+    return sketch;
+}
+
 void CGovernanceManager::MasternodeRateUpdate(const CGovernanceObject& govobj)
 {
     if (govobj.GetObjectType() != GOVERNANCE_OBJECT_TRIGGER) return;
@@ -789,7 +949,7 @@ bool CGovernanceManager::MasternodeRateCheck(const CGovernanceObject& govobj, bo
     return false;
 }
 
-bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman)
+bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman, bool fSigChecked)
 {
     ENTER_CRITICAL_SECTION(cs);
     uint256 nHashVote = vote.GetHash();
@@ -838,11 +998,160 @@ bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote,
         return false;
     }
 
-    bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman) && cmapVoteToObject.Insert(nHashVote, &govobj);
+    bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman, fSigChecked) && cmapVoteToObject.Insert(nHashVote, &govobj);
     LEAVE_CRITICAL_SECTION(cs);
     return fOk;
 }
 
+void VerifyVoteSignatures(std::unordered_map<uint256, CGovernanceVoteSigCheckItem, StaticSaltedHasher>& sigChecks)
+{
+    // Secure verification is required here, as the vote hash doesn't cover the signature. With insecure aggregation,
+    // the signatures of two votes could be shifted against each other and would still verify in aggregate
+    CBLSBatchVerifier<NodeId, uint256> batchVerifier(true, true, 8);
+    std::vector<CGovernanceVoteSigCheck> vChecks;
+    std::vector<uint256> vecBLSHashes;
+    for (auto& p : sigChecks) {
+        auto& c = p.second;
+        if (c.fUseVotingKey) {
+            vChecks.emplace_back(*c.vote, c.keyIDVoting, c.fValid);
+            continue;
+        }
+        CBLSSignature sig;
+        sig.SetBuf(c.vote->GetSignature());
+        if (!sig.IsValid() || !c.pubKeyOperator.IsValid()) {
+            // fValid stays false
+            continue;
+        }
+        batchVerifier.PushMessage(c.nodeId, p.first, c.vote->GetSignatureHash(), sig, c.pubKeyOperator);
+        vecBLSHashes.emplace_back(p.first);
+    }
+
+    if (nScriptCheckThreads && vChecks.size() > 1) {
+        CCheckQueueControl<CGovernanceVoteSigCheck> control(&govvotecheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    } else {
+        for (auto& check : vChecks) {
+            check();
+        }
+    }
+
+    batchVerifier.Verify();
+    for (const auto& nHash : vecBLSHashes) {
+        sigChecks.at(nHash).fValid = !batchVerifier.badMessages.count(nHash);
+    }
+}
+
+void CGovernanceManager::ProcessPendingVotes(CConnman& connman)
+{
+    decltype(mapPendingVotes) pend;
+    {
+        LOCK(cs);
+        if (mapPendingVotes.size() <= MAX_PENDING_VOTES_BATCH) {
+            pend = std::move(mapPendingVotes);
+            mapPendingVotes.clear();
+            mapPendingVotesPerPeer.clear();
+        } else {
+            auto it = mapPendingVotes.begin();
+            while (pend.size() < MAX_PENDING_VOTES_BATCH) {
+                auto itPeer = mapPendingVotesPerPeer.find(it->second.first);
+                if (itPeer != mapPendingVotesPerPeer.end() && --itPeer->second == 0) {
+                    mapPendingVotesPerPeer.erase(itPeer);
+                }
+                pend.emplace(it->first, std::move(it->second));
+                it = mapPendingVotes.erase(it);
+            }
+        }
+    }
+
+    if (pend.empty()) {
+        return;
+    }
+
+    int64_t nTimeStart = GetTimeMicros();
+
+    std::unordered_map<uint256, CGovernanceVoteSigCheckItem, StaticSaltedHasher> sigChecks;
+
+    auto mnList = deterministicMNManager->GetListAtChainTip();
+    {
+        LOCK(cs);
+        for (const auto& p : pend) {
+            const CGovernanceVote& vote = p.second.second;
+            // unknown parents and masternodes are handled by ProcessVote, which also verifies the signature then
+            auto itObj = mapObjects.find(vote.GetParentHash());
+            if (itObj == mapObjects.end()) {
+                continue;
+            }
+            auto dmn = mnList.GetMNByCollateral(vote.GetMasternodeOutpoint());
+            if (!dmn) {
+                continue;
+            }
+            bool onlyVotingKeyAllowed = itObj->second.GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL && vote.GetSignal() == VOTE_SIGNAL_FUNDING;
+            sigChecks.emplace(p.first, CGovernanceVoteSigCheckItem{p.second.first, &vote, onlyVotingKeyAllowed, dmn->pdmnState->keyIDVoting, dmn->pdmnState->pubKeyOperator.Get()});
+        }
+    }
+
+    VerifyVoteSignatures(sigChecks);
+
+    int64_t nTimeVerify = GetTimeMicros();
+    LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- verified %d vote signatures in %.2fms\n", __func__,
+        sigChecks.size(), 0.001 * (nTimeVerify - nTimeStart));
+
+    // ProcessVote needs the sender to request the parent object in case it was deleted while the vote was pending
+    std::vector<CNode*> vNodesCopy = connman.CopyNodeVector(CConnman::FullyConnectedOnly);
+    std::map<NodeId, CNode*> mapNodes;
+    for (CNode* pnode : vNodesCopy) {
+        mapNodes.emplace(pnode->GetId(), pnode);
+    }
+
+    std::map<NodeId, int> mapPenalties;
+    for (const auto& p : pend) {
+        const uint256& nHash = p.first;
+        NodeId nodeId = p.second.first;
+        const CGovernanceVote& vote = p.second.second;
+
+        auto itCheck = sigChecks.find(nHash);
+        if (itCheck != sigChecks.end() && !itCheck->second.fValid) {
+            LogPrintf("CGovernanceManager::%s -- Invalid vote signature, MN outpoint = %s, governance object hash = %s, vote hash = %s, peer=%d\n", __func__,
+                vote.GetMasternodeOutpoint().ToStringShort(), vote.GetParentHash().ToString(), nHash.ToString(), nodeId);
+            {
+                LOCK(cs);
+                AddInvalidVote(vote);
+            }
+            mapPenalties[nodeId] += 20;
+            continue;
+        }
+
+        CGovernanceException exception;
+        auto itNode = mapNodes.find(nodeId);
+        CNode* pfrom = itNode != mapNodes.end() ? itNode->second : nullptr;
+        if (ProcessVote(pfrom, vote, exception, connman, itCheck != sigChecks.end())) {
+            LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- %s new\n", __func__, nHash.ToString());
+            masternodeSync.BumpAssetLastTime("MNGOVERNANCEOBJECTVOTE");
+            vote.Relay(connman);
+            // SEND NOTIFICATION TO SCRIPT/ZMQ
+            GetMainSignals().NotifyGovernanceVote(vote);
+        } else {
+            LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- Rejected vote, error = %s\n", __func__, exception.what());
+            if ((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
+                mapPenalties[nodeId] += exception.GetNodePenalty();
+            }
+        }
+    }
+
+    connman.ReleaseNodeVector(vNodesCopy);
+
+    if (!mapPenalties.empty()) {
+        LOCK(cs_main);
+        for (const auto& p : mapPenalties) {
+            Misbehaving(p.first, p.second);
+        }
+    }
+
+    LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- processed %d votes in %.2fms\n", __func__,
+        pend.size(), 0.001 * (GetTimeMicros() - nTimeStart));
+}
+
 void CGovernanceManager::CheckPostponedObjects(CConnman& connman)
 {
     if (!masternodeSync.IsSynced()) return;
@@ -923,6 +1232,13 @@ void CGovernanceManager::RequestGovernanceObject(CNode* pfrom, const uint256& nH
         return;
     }
 
+    if (fUseFilter && pfrom->nVersion >= GOVERNANCE_RECONCILIATION_PROTO_VERSION) {
+        CGovernanceReconSketch sketch = GetVotesReconSketch(nHash);
+        LogPrint(BCLog::GOBJECT, "CGovernanceManager::RequestGovernanceObject -- nHash %s nBucketBits %d peer=%d\n", nHash.ToString(), sketch.GetBucketBits(), pfrom->GetId());
+        connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::MNGOVERNANCERECON, nHash, sketch));
+        return;
+    }
+
     CBloomFilter filter;
     filter.clear();
 
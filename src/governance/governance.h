@@ -11,8 +11,10 @@
 #include "chain.h"
 #include "governance-exceptions.h"
 #include "governance-object.h"
+#include "governance-reconcile.h"
 #include "governance-vote.h"
 #include "net.h"
+#include "saltedhasher.h"
 #include "sync.h"
 #include "timedata.h"
 #include "util.h"
@@ -21,6 +23,8 @@
 
 #include <univalue.h>
 
+#include <unordered_map>
+
 class CGovernanceManager;
 class CGovernanceTriggerManager;
 class CGovernanceObject;
@@ -40,6 +44,31 @@ typedef std::pair<CGovernanceObject, ExpirationInfo> object_info_pair_t;
 
 static const int RATE_BUFFER_SIZE = 5;
 
+static const size_t MAX_PENDING_VOTES_BATCH = 4096;
+// Votes above these limits are not queued for batch verification but verified and processed right away, which slows
+// down the sending peer instead of growing the queue
+static const size_t MAX_PENDING_VOTES_PER_PEER = 20000;
+static const size_t MAX_PENDING_VOTES = 100000;
+
+/** Run an instance of the governance vote signature checking thread */
+void ThreadGovernanceVoteCheck();
+
+/** Signature check of a pending vote, fValid is set by VerifyVoteSignatures */
+struct CGovernanceVoteSigCheckItem {
+    NodeId nodeId;
+    const CGovernanceVote* vote;
+    bool fUseVotingKey;
+    CKeyID keyIDVoting;
+    CBLSPublicKey pubKeyOperator;
+    bool fValid{false};
+};
+
+/**
+ * Verifies the vote signatures, operator (BLS) signatures are batch verified and voting key (ECDSA) signatures are
+ * verified in parallel. An invalid signature only marks its own vote as invalid.
+ */
+void VerifyVoteSignatures(std::unordered_map<uint256, CGovernanceVoteSigCheckItem, StaticSaltedHasher>& sigChecks);
+
 class CRateCheckBuffer
 {
 private:
@@ -248,6 +277,10 @@ private:
 
     hash_s_t setRequestedVotes;
 
+    // votes for known objects which wait for batched signature verification, see ProcessPendingVotes
+    std::unordered_map<uint256, std::pair<NodeId, CGovernanceVote>, StaticSaltedHasher> mapPendingVotes;
+    std::map<NodeId, size_t> mapPendingVotesPerPeer;
+
     bool fRateChecksEnabled;
 
     // used to check for changed voting keys
@@ -288,13 +321,23 @@ public:
      */
     bool ConfirmInventoryRequest(const CInv& inv);
 
-    void SyncSingleObjVotes(CNode* pnode, const uint256& nProp, const CBloomFilter& filter, CConnman& connman);
-    void SyncObjects(CNode* pnode, CConnman& connman) const;
+    // If pSketch is set, only the items in the buckets in which it differs from our own sketch are announced
+    void SyncSingleObjVotes(CNode* pnode, const uint256& nProp, const CBloomFilter& filter, CConnman& connman, const CGovernanceReconSketch* pSketch = nullptr);
+    void SyncObjects(CNode* pnode, CConnman& connman, const CGovernanceReconSketch* pSketch = nullptr) const;
+
+    CGovernanceReconSketch GetObjectsReconSketch() const;
+    CGovernanceReconSketch GetVotesReconSketch(const uint256& nProp) const;
 
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
 
     void DoMaintenance(CConnman& connman);
 
+    /**
+     * Verifies the signatures of up to MAX_PENDING_VOTES_BATCH pending votes at once and then processes them.
+     * Operator (BLS) signatures are batch verified, voting key (ECDSA) signatures are verified in parallel.
+     */
+    void ProcessPendingVotes(CConnman& connman);
+
     CGovernanceObject* FindGovernanceObject(const uint256& nHash);
 
     // These commands are only used in RPC
@@ -403,12 +446,14 @@ public:
 private:
     void RequestGovernanceObject(CNode* pfrom, const uint256& nHash, CConnman& connman, bool fUseFilter = false);
 
+    static void FilterReconciledHashes(std::vector<uint256>& vecHashes, const CGovernanceReconSketch& peerSketch);
+
     void AddInvalidVote(const CGovernanceVote& vote)
     {
         cmapInvalidVotes.Insert(vote.GetHash(), vote);
     }
 
-    bool ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman);
+    bool ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman, bool fSigChecked = false);
 
     /// Called to indicate a requested object has been received
     bool AcceptObjectMessage(const uint256& nHash);
@@ -17,11 +17,35 @@
 #include "crypto/hmac_sha256.h"
 #include <stdio.h>
 
+#include <set>
+
 #include <boost/algorithm/string.hpp> // boost::trim
 
 /** WWW-Authenticate to present with 401 Unauthorized response */
 static const char* WWW_AUTH_HEADER_DATA = "Basic realm=\"jsonrpc\"";
 
+/** Bodies larger than this are not parsed by the classifier and go to the heavy work queue */
+static const size_t MAX_CLASSIFY_BODY_SIZE = 64 * 1024;
+
+/** Methods which may take long (index scans, full UTXO set or mempool walks, governance/masternode list dumps) */
+static const std::set<std::string> heavyRPCMethods = {
+    "getaddressbalance",
+    "getaddressdeltas",
+    "getaddressmempool",
+    "getaddresstxids",
+    "getaddressutxos",
+    "getblockhashes",
+    "getchaintips",
+    "getrawmempool",
+    "getspentinfo",
+    "gettxoutsetinfo",
+    "gobject",
+    "masternodelist",
+    "protx",
+    "quorum",
+    "verifychain",
+};
+
 /** Simple one-shot callback timer to be used by the RPC mechanism to e.g.
  * re-lock the wallet.
  */
@@ -208,6 +232,65 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
     return true;
 }
 
+static HTTPWorkQueueClass ClassifyRPCMethod(const std::string& method)
+{
+    if (heavyRPCMethods.count(method)) {
+        return HTTPWorkQueueClass::HEAVY;
+    }
+    const CRPCCommand* cmd = tableRPC[method];
+    if (cmd && cmd->category == "wallet") {
+        return HTTPWorkQueueClass::WALLET;
+    }
+    return HTTPWorkQueueClass::FAST;
+}
+
+static HTTPWorkQueueClass HTTPReq_JSONRPC_Classify(HTTPRequest* req, const std::string &)
+{
+    if (req->GetURI().compare(0, 8, "/wallet/") == 0) {
+        return HTTPWorkQueueClass::WALLET;
+    }
+    if (req->GetRequestMethod() != HTTPRequest::POST) {
+        return HTTPWorkQueueClass::FAST;
+    }
+
+    if (req->GetBodySize() > MAX_CLASSIFY_BODY_SIZE) {
+        return HTTPWorkQueueClass::HEAVY;
+    }
+    std::string body = req->PeekBody(MAX_CLASSIFY_BODY_SIZE);
+
+    // This runs on the event loop thread and before authentication, so don't parse the body. Instead, look for the
+    // values of all "method" keys. Batches are handled by the queue of their slowest request. Anything which can't be
+    // understood this way ends up on the fast queue, where the worker produces the proper error
+    static const std::string strMethodKey = "\"method\"";
+    static const size_t MAX_METHOD_NAME_LENGTH = 64;
+    HTTPWorkQueueClass ret = HTTPWorkQueueClass::FAST;
+    size_t pos = 0;
+    while ((pos = body.find(strMethodKey, pos)) != std::string::npos) {
+        pos += strMethodKey.size();
+        pos = body.find_first_not_of(" \t\r\n", pos);
+        if (pos == std::string::npos || body[pos] != ':') {
+            continue;
+        }
+        pos = body.find_first_not_of(" \t\r\n", pos + 1);
+        if (pos == std::string::npos || body[pos] != '"') {
+            continue;
+        }
+        size_t end = body.find('"', pos + 1);
+        if (end == std::string::npos || end - pos - 1 > MAX_METHOD_NAME_LENGTH) {
+            continue;
+        }
+        HTTPWorkQueueClass c = ClassifyRPCMethod(body.substr(pos + 1, end - pos - 1));
+        if (c == HTTPWorkQueueClass::HEAVY) {
+            return c;
+        }
+        if (c == HTTPWorkQueueClass::WALLET) {
+            ret = c;
+        }
+        pos = end + 1;
+    }
+    return ret;
+}
+
 static bool InitRPCAuthentication()
 {
     if (gArgs.GetArg("-rpcpassword", "") == "")
@@ -232,10 +315,10 @@ bool StartHTTPRPC()
     if (!InitRPCAuthentication())
         return false;
 
-    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC);
+    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC, HTTPReq_JSONRPC_Classify);
 #ifdef ENABLE_WALLET
     // ifdef can be removed once we switch to better endpoint support and API versioning
-    RegisterHTTPHandler("/wallet/", false, HTTPReq_JSONRPC);
+    RegisterHTTPHandler("/wallet/", false, HTTPReq_JSONRPC, HTTPReq_JSONRPC_Classify);
 #endif
     assert(EventBase());
     httpRPCTimerInterface = new HTTPRPCTimerInterface(EventBase());
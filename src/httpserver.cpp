@@ -40,6 +40,8 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
@@ -74,13 +76,21 @@ private:
     /** Mutex protects entire object */
     std::mutex cs;
     std::condition_variable cond;
-    std::deque<std::unique_ptr<WorkItem>> queue;
+    /** Work items together with the time (in microseconds) they were enqueued */
+    std::deque<std::pair<std::unique_ptr<WorkItem>, int64_t>> queue;
     bool running;
     size_t maxDepth;
+    std::string name;
+    int threads{0};
+    uint64_t processed{0};
+    uint64_t rejected{0};
+    int64_t totalQueueTime{0};
+    int64_t maxQueueTime{0};
 
 public:
-    WorkQueue(size_t _maxDepth) : running(true),
-                                 maxDepth(_maxDepth)
+    WorkQueue(size_t _maxDepth, const std::string& _name) : running(true),
+                                 maxDepth(_maxDepth),
+                                 name(_name)
     {
     }
     /** Precondition: worker threads have all stopped (they have been joined).
@@ -88,20 +98,29 @@ public:
     ~WorkQueue()
     {
     }
+    const std::string& GetName() const
+    {
+        return name;
+    }
     /** Enqueue a work item */
     bool Enqueue(WorkItem* item)
     {
         std::unique_lock<std::mutex> lock(cs);
         if (queue.size() >= maxDepth) {
+            rejected++;
             return false;
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        queue.emplace_back(std::unique_ptr<WorkItem>(item), GetTimeMicros());
         cond.notify_one();
         return true;
     }
     /** Thread function */
     void Run()
     {
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            threads++;
+        }
         while (true) {
             std::unique_ptr<WorkItem> i;
             {
@@ -110,8 +129,13 @@ public:
                     cond.wait(lock);
                 if (!running)
                     break;
-                i = std::move(queue.front());
+                i = std::move(queue.front().first);
+                int64_t queueTime = GetTimeMicros() - queue.front().second;
                 queue.pop_front();
+                processed++;
+                totalQueueTime += queueTime;
+                maxQueueTime = std::max(maxQueueTime, queueTime);
+                LogPrint(BCLog::HTTP, "Work item waited %.2fms in %s work queue\n", queueTime * 0.001, name);
             }
             (*i)();
         }
@@ -123,18 +147,33 @@ public:
         running = false;
         cond.notify_all();
     }
+    HTTPWorkQueueStats GetStats()
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        HTTPWorkQueueStats stats;
+        stats.name = name;
+        stats.threads = threads;
+        stats.depth = queue.size();
+        stats.maxDepth = maxDepth;
+        stats.processed = processed;
+        stats.rejected = rejected;
+        stats.totalQueueTime = totalQueueTime;
+        stats.maxQueueTime = maxQueueTime;
+        return stats;
+    }
 };
 
 struct HTTPPathHandler
 {
     HTTPPathHandler() {}
-    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler):
-        prefix(_prefix), exactMatch(_exactMatch), handler(_handler)
+    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler, HTTPRequestClassifier _classifier):
+        prefix(_prefix), exactMatch(_exactMatch), handler(_handler), classifier(_classifier)
     {
     }
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
+    HTTPRequestClassifier classifier;
 };
 
 /** HTTP module state */
@@ -145,8 +184,8 @@ static struct event_base* eventBase = 0;
 struct evhttp* eventHTTP = 0;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
-//! Work queue for handling longer requests off the event loop thread
-static WorkQueue<HTTPClosure>* workQueue = 0;
+//! Work queues for handling longer requests off the event loop thread, indexed by HTTPWorkQueueClass
+static std::vector<std::unique_ptr<WorkQueue<HTTPClosure>>> workQueues;
 //! Handlers for (sub)paths
 std::vector<HTTPPathHandler> pathHandlers;
 //! Bound listening sockets
@@ -261,12 +300,14 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
+        HTTPWorkQueueClass queueClass = i->classifier ? i->classifier(hreq.get(), path) : HTTPWorkQueueClass::FAST;
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
-        assert(workQueue);
+        assert(workQueues.size() == (size_t)HTTPWorkQueueClass::COUNT);
+        auto& workQueue = workQueues[(size_t)queueClass];
         if (workQueue->Enqueue(item.get()))
             item.release(); /* if true, queue took ownership */
         else {
-            LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
+            LogPrintf("WARNING: request rejected because http %s work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n", workQueue->GetName());
             item->req->WriteReply(HTTP_INTERNAL, "Work queue depth exceeded");
         }
     } else {
@@ -331,9 +372,9 @@ static bool HTTPBindAddresses(struct evhttp* http)
 }
 
 /** Simple wrapper to set thread name and run work queue */
-static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue)
+static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue, const std::string& threadName)
 {
-    RenameThread("dash-httpworker");
+    RenameThread(threadName.c_str());
     queue->Run();
 }
 
@@ -400,9 +441,12 @@ bool InitHTTPServer()
 
     LogPrint(BCLog::HTTP, "Initialized HTTP server\n");
     int workQueueDepth = std::max((long)gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
-    LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
+    LogPrintf("HTTP: creating work queues of depth %d\n", workQueueDepth);
 
-    workQueue = new WorkQueue<HTTPClosure>(workQueueDepth);
+    // must match the order of HTTPWorkQueueClass
+    workQueues.emplace_back(new WorkQueue<HTTPClosure>(workQueueDepth, "fast"));
+    workQueues.emplace_back(new WorkQueue<HTTPClosure>(workQueueDepth, "heavy"));
+    workQueues.emplace_back(new WorkQueue<HTTPClosure>(workQueueDepth, "wallet"));
     // tranfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -430,11 +474,19 @@ bool StartHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Starting HTTP server\n");
     int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogPrintf("HTTP: starting %d worker threads\n", rpcThreads);
+    int rpcHeavyThreads = std::max((long)gArgs.GetArg("-rpcheavythreads", DEFAULT_HTTP_HEAVY_THREADS), 1L);
+    int rpcWalletThreads = std::max((long)gArgs.GetArg("-rpcwalletthreads", DEFAULT_HTTP_WALLET_THREADS), 1L);
+    LogPrintf("HTTP: starting %d fast, %d heavy and %d wallet worker threads\n", rpcThreads, rpcHeavyThreads, rpcWalletThreads);
     threadHTTP = std::thread(ThreadHTTP, eventBase, eventHTTP);
 
     for (int i = 0; i < rpcThreads; i++) {
-        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueue);
+        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueues[(size_t)HTTPWorkQueueClass::FAST].get(), "dash-httpworker");
+    }
+    for (int i = 0; i < rpcHeavyThreads; i++) {
+        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueues[(size_t)HTTPWorkQueueClass::HEAVY].get(), "dash-httpheavy");
+    }
+    for (int i = 0; i < rpcWalletThreads; i++) {
+        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueues[(size_t)HTTPWorkQueueClass::WALLET].get(), "dash-httpwallet");
     }
     return true;
 }
@@ -446,21 +498,20 @@ void InterruptHTTPServer()
         // Reject requests on current connections
         evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
     }
-    if (workQueue)
+    for (auto& workQueue : workQueues)
         workQueue->Interrupt();
 }
 
 void StopHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Stopping HTTP server\n");
-    if (workQueue) {
+    if (!workQueues.empty()) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
         for (auto& thread: g_thread_http_workers) {
             thread.join();
         }
         g_thread_http_workers.clear();
-        delete workQueue;
-        workQueue = nullptr;
+        workQueues.clear();
     }
     // Unlisten sockets, these are what make the event loop running, which means
     // that after this and all connections are closed the event loop will quit.
@@ -488,6 +539,15 @@ struct event_base* EventBase()
     return eventBase;
 }
 
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats()
+{
+    std::vector<HTTPWorkQueueStats> ret;
+    for (auto& workQueue : workQueues) {
+        ret.emplace_back(workQueue->GetStats());
+    }
+    return ret;
+}
+
 static void httpevent_callback_fn(evutil_socket_t, short, void* data)
 {
     // Static handler: simply call inner handler
@@ -559,6 +619,29 @@ std::string HTTPRequest::ReadBody()
     return rv;
 }
 
+size_t HTTPRequest::GetBodySize()
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return 0;
+    return evbuffer_get_length(buf);
+}
+
+std::string HTTPRequest::PeekBody(size_t maxSize)
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return "";
+    size_t size = std::min(evbuffer_get_length(buf), maxSize);
+    // Copies out of the (possibly multi-segment) buffer without linearizing or draining it
+    std::string rv(size, '\0');
+    ev_ssize_t copied = evbuffer_copyout(buf, &rv[0], size);
+    if (copied < 0)
+        return "";
+    rv.resize(copied);
+    return rv;
+}
+
 void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 {
     struct evkeyvalq* headers = evhttp_request_get_output_headers(req);
@@ -641,10 +724,11 @@ HTTPRequest::RequestMethod HTTPRequest::GetRequestMethod()
     }
 }
 
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler)
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler,
+                         const HTTPRequestClassifier &classifier)
 {
     LogPrint(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
-    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler));
+    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler, classifier));
 }
 
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
@@ -8,8 +8,11 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <vector>
 
 static const int DEFAULT_HTTP_THREADS=4;
+static const int DEFAULT_HTTP_HEAVY_THREADS=2;
+static const int DEFAULT_HTTP_WALLET_THREADS=2;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
 
@@ -36,13 +39,26 @@ void StopHTTPServer();
  * libevent doesn't support debug logging.*/
 bool UpdateHTTPServerLogging(bool enable);
 
+/** Requests are handled by separate work queues and worker threads depending on their class,
+ * so that slow requests can't starve fast ones.
+ */
+enum class HTTPWorkQueueClass {
+    FAST,
+    HEAVY,
+    WALLET,
+    COUNT
+};
+
 /** Handler for requests to a certain HTTP path */
 typedef std::function<bool(HTTPRequest* req, const std::string &)> HTTPRequestHandler;
+/** Determines the work queue of a request. Called from the HTTP event thread, so it must be cheap */
+typedef std::function<HTTPWorkQueueClass(HTTPRequest* req, const std::string &)> HTTPRequestClassifier;
 /** Register handler for prefix.
  * If multiple handlers match a prefix, the first-registered one will
- * be invoked.
+ * be invoked. Requests are handled by the FAST work queue if no classifier is given.
  */
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler);
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler,
+                         const HTTPRequestClassifier &classifier = nullptr);
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
@@ -51,6 +67,20 @@ void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
  */
 struct event_base* EventBase();
 
+struct HTTPWorkQueueStats
+{
+    std::string name;
+    int threads;
+    size_t depth;
+    size_t maxDepth;
+    uint64_t processed;
+    uint64_t rejected;
+    int64_t totalQueueTime; // microseconds
+    int64_t maxQueueTime; // microseconds
+};
+/** Return the statistics of all work queues, empty if the HTTP server is not running */
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats();
+
 /** In-flight HTTP request.
  * Thin C++ wrapper around evhttp_request.
  */
@@ -98,6 +128,16 @@ public:
      */
     std::string ReadBody();
 
+    /**
+     * Return the size of the request body.
+     */
+    size_t GetBodySize();
+
+    /**
+     * Return a copy of at most maxSize bytes of the request body without consuming it.
+     */
+    std::string PeekBody(size_t maxSize);
+
     /**
      * Write output header.
      *
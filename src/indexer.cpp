@@ -0,0 +1,469 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "indexer.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "hash.h"
+#include "init.h"
+#include "txdb.h"
+#include "ui_interface.h"
+#include "undo.h"
+#include "util.h"
+#include "utiltime.h"
+#include "validation.h"
+#include "warnings.h"
+
+#include <future>
+
+std::unique_ptr<CIndexer> g_indexer;
+
+// Number of blocks which are read and processed in parallel while catching up with the chain
+static const size_t MAX_BLOCKS_PER_ROUND = 64;
+static const int MAX_INDEXER_WORKERS = 8;
+static const int64_t SYNC_LOG_INTERVAL = 30; // seconds
+
+static void FatalError(const std::string& strMessage)
+{
+    SetMiscWarning(strMessage);
+    LogPrintf("*** %s\n", strMessage);
+    uiInterface.ThreadSafeMessageBox(_("Error: A fatal internal error occurred, see debug.log for details"), "", CClientUIInterface::MSG_ERROR);
+    StartShutdown();
+}
+
+// Returns the address type (1 for P2PKH and P2PK, 2 for P2SH) and sets hashBytes, or returns 0 for all other scripts
+static int GetScriptAddress(const CScript& script, uint160& hashBytes)
+{
+    if (script.IsPayToScriptHash()) {
+        hashBytes = uint160(std::vector<unsigned char>(script.begin()+2, script.begin()+22));
+        return 2;
+    } else if (script.IsPayToPublicKeyHash()) {
+        hashBytes = uint160(std::vector<unsigned char>(script.begin()+3, script.begin()+23));
+        return 1;
+    } else if (script.IsPayToPublicKey()) {
+        hashBytes = Hash160(script.begin()+1, script.end()-1);
+        return 1;
+    }
+    hashBytes.SetNull();
+    return 0;
+}
+
+CIndexer::CIndexer()
+{
+}
+
+CIndexer::~CIndexer()
+{
+    Interrupt();
+    if (workThread.joinable()) {
+        workThread.join();
+    }
+}
+
+bool CIndexer::Init()
+{
+    LOCK(cs_main);
+
+    uint256 hashBest;
+    if (!pblocktree->ReadIndexBestBlock(hashBest)) {
+        // Older versions updated the indexes in ConnectBlock, so they match the chainstate. This doesn't hold with
+        // -reindex-chainstate, which rebuilds the chainstate from the genesis block
+        if (!fReindex && gArgs.GetBoolArg("-reindex-chainstate", false)) {
+            return error("%s: last indexed block unknown, -reindex is required", __func__);
+        }
+        if (chainActive.Tip() != nullptr) {
+            hashBest = chainActive.Tip()->GetBlockHash();
+        }
+        if (!pblocktree->WriteIndexBestBlock(hashBest)) {
+            return error("%s: failed to write last indexed block", __func__);
+        }
+    }
+
+    if (!hashBest.IsNull()) {
+        auto it = mapBlockIndex.find(hashBest);
+        if (it == mapBlockIndex.end()) {
+            return error("%s: last indexed block %s not found", __func__, hashBest.ToString());
+        }
+        pindexBest = it->second;
+    }
+    pindexFlushed = pindexBest;
+
+    LogPrintf("%s: last indexed block at height %d\n", __func__, pindexBest ? pindexBest->nHeight : -1);
+    return true;
+}
+
+void CIndexer::Start()
+{
+    // can't start new thread if we have one running already
+    if (workThread.joinable()) {
+        assert(false);
+    }
+
+    int workerCount = std::max(1, std::min(GetNumCores() - 1, MAX_INDEXER_WORKERS));
+    workerPool.resize(workerCount);
+    RenameThreadPool(workerPool, "dash-idx-worker");
+
+    RegisterValidationInterface(this);
+    workThread = std::thread(&TraceThread<std::function<void()> >, "indexer", std::function<void()>(std::bind(&CIndexer::ThreadIndexer, this)));
+}
+
+void CIndexer::Interrupt()
+{
+    std::lock_guard<std::mutex> l(cs);
+    fInterrupted = true;
+    cvWork.notify_all();
+    cvFlushed.notify_all();
+}
+
+void CIndexer::Stop()
+{
+    UnregisterValidationInterface(this);
+
+    if (workThread.joinable()) {
+        workThread.join();
+    }
+    workerPool.clear_queue();
+    workerPool.stop(true);
+
+    if (!Flush()) {
+        LogPrintf("%s: failed to write address/spent/timestamp indexes\n", __func__);
+    }
+}
+
+void CIndexer::BlockUntilSyncedToCurrentChain()
+{
+    AssertLockNotHeld(cs_main);
+
+    if (!fSynced || IsInitialBlockDownload()) {
+        return;
+    }
+
+    while (true) {
+        const CBlockIndex* pindexTip;
+        {
+            LOCK(cs_main);
+            pindexTip = chainActive.Tip();
+        }
+        // The tip might get disconnected before the indexer reaches it, so wait for the new tip in that case
+        std::unique_lock<std::mutex> l(cs);
+        if (cvFlushed.wait_for(l, std::chrono::milliseconds(100), [&] { return fInterrupted || pindexFlushed == pindexTip; })) {
+            return;
+        }
+    }
+}
+
+void CIndexer::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted)
+{
+    WakeUp();
+}
+
+void CIndexer::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindexDisconnected)
+{
+    WakeUp();
+}
+
+void CIndexer::WakeUp()
+{
+    std::lock_guard<std::mutex> l(cs);
+    fWorkPending = true;
+    cvWork.notify_one();
+}
+
+void CIndexer::ThreadIndexer()
+{
+    int64_t nLastSyncLogTime = 0;
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> l(cs);
+            if (fInterrupted) {
+                return;
+            }
+            fWorkPending = false;
+        }
+
+        const CBlockIndex* pindexDisconnect = nullptr;
+        std::vector<const CBlockIndex*> vpindexConnect;
+        bool fChainstateBehind = false;
+        {
+            LOCK(cs_main);
+            const CBlockIndex* pindexTip = chainActive.Tip();
+            if (pindexBest != nullptr && !chainActive.Contains(pindexBest)) {
+                // After a crash or with -reindex-chainstate, the chainstate can be behind the indexes. Wait until it
+                // connects the last indexed block again instead of undoing all blocks which are not connected yet
+                fChainstateBehind = !(pindexBest->nStatus & BLOCK_FAILED_MASK) &&
+                                    (pindexTip == nullptr || pindexBest->GetAncestor(pindexTip->nHeight) == pindexTip);
+                if (!fChainstateBehind) {
+                    pindexDisconnect = pindexBest;
+                }
+            } else {
+                const CBlockIndex* pindex = pindexBest == nullptr ? chainActive.Genesis() : chainActive.Next(pindexBest);
+                while (pindex != nullptr && vpindexConnect.size() < MAX_BLOCKS_PER_ROUND) {
+                    vpindexConnect.emplace_back(pindex);
+                    pindex = chainActive.Next(pindex);
+                }
+            }
+        }
+
+        if (pindexDisconnect != nullptr) {
+            if (!DisconnectBlock(pindexDisconnect)) {
+                FatalError(strprintf("Failed to undo block %s in the address/spent/timestamp indexes", pindexDisconnect->GetBlockHash().ToString()));
+                return;
+            }
+            continue;
+        }
+
+        if (!vpindexConnect.empty()) {
+            if (!fSynced && GetTime() - nLastSyncLogTime >= SYNC_LOG_INTERVAL) {
+                LogPrintf("Syncing address/spent/timestamp indexes with block chain from height %d\n", vpindexConnect.front()->nHeight);
+                nLastSyncLogTime = GetTime();
+            }
+            if (!ConnectBlocks(vpindexConnect)) {
+                FatalError("Failed to write address/spent/timestamp indexes");
+                return;
+            }
+            continue;
+        }
+
+        // Nothing to do right now. Entries collected during initial block download are written once it finished
+        if (!IsInitialBlockDownload() && !Flush()) {
+            FatalError("Failed to write address/spent/timestamp indexes");
+            return;
+        }
+        if (!fChainstateBehind && !fSynced) {
+            fSynced = true;
+            LogPrintf("address/spent/timestamp indexes are synced with block chain at height %d\n", pindexBest ? pindexBest->nHeight : -1);
+        }
+
+        std::unique_lock<std::mutex> l(cs);
+        // wake up from time to time to notice the end of initial block download
+        cvWork.wait_for(l, std::chrono::seconds(1), [this] { return fInterrupted || fWorkPending; });
+    }
+}
+
+bool CIndexer::ConnectBlocks(const std::vector<const CBlockIndex*>& vpindex)
+{
+    // Reading the blocks and computing their entries can be done in parallel, applying them has to happen in order
+    std::vector<BlockIndexEntries> vEntries(vpindex.size());
+    if (vpindex.size() == 1) {
+        if (!GetConnectEntries(vpindex[0], vEntries[0])) {
+            return false;
+        }
+    } else {
+        std::vector<std::future<bool> > futures;
+        futures.reserve(vpindex.size());
+        for (size_t i = 0; i < vpindex.size(); i++) {
+            futures.emplace_back(workerPool.push([&vpindex, &vEntries, i](int threadId) {
+                return GetConnectEntries(vpindex[i], vEntries[i]);
+            }));
+        }
+        bool fOk = true;
+        for (auto& f : futures) {
+            fOk &= f.get();
+        }
+        if (!fOk) {
+            return false;
+        }
+    }
+
+    // While syncing, the entries of many blocks are written at once, either when the pending batch grows too large
+    // or when the indexer caught up with the chain
+    bool fFlush = !IsInitialBlockDownload();
+    for (size_t i = 0; i < vpindex.size(); i++) {
+        const CBlockIndex* pindex = vpindex[i];
+        const auto& entries = vEntries[i];
+        // the genesis block is not connected, so it's not in the timestamp index either
+        CTimestampIndexKey timestampIndex(pindex->nTime, pindex->GetBlockHash());
+        bool fTimestamp = fTimestampIndex && pindex->pprev != nullptr;
+        if (!pblocktree->WriteBlockIndexes(entries.addressIndex, entries.addressUnspentIndex, entries.spentIndex,
+                                           fTimestamp ? &timestampIndex : nullptr, pindex->nHeight, pindex->GetBlockHash(), fAddressBalanceIndex)) {
+            return error("%s: failed to write indexes of block %s", __func__, pindex->GetBlockHash().ToString());
+        }
+        pindexBest = pindex;
+        if (fFlush && !Flush()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CIndexer::DisconnectBlock(const CBlockIndex* pindex)
+{
+    assert(pindex->pprev);
+
+    BlockIndexEntries entries;
+    if (!GetDisconnectEntries(pindex, entries)) {
+        return false;
+    }
+
+    CTimestampIndexKey timestampIndex(pindex->nTime, pindex->GetBlockHash());
+    if (!pblocktree->UndoBlockIndexes(entries.addressIndex, entries.addressUnspentIndex, entries.spentIndex,
+                                      fTimestampIndex ? &timestampIndex : nullptr, pindex->nHeight, pindex->pprev->GetBlockHash(), fAddressBalanceIndex)) {
+        return error("%s: failed to undo indexes of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    pindexBest = pindex->pprev;
+
+    // UndoBlockIndexes() writes all pending entries
+    std::lock_guard<std::mutex> l(cs);
+    pindexFlushed = pindexBest;
+    cvFlushed.notify_all();
+    return true;
+}
+
+bool CIndexer::Flush()
+{
+    if (!pblocktree->FlushIndexBatch()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> l(cs);
+    pindexFlushed = pindexBest;
+    cvFlushed.notify_all();
+    return true;
+}
+
+bool CIndexer::ReadBlockAndUndo(const CBlockIndex* pindex, CBlock& block, CBlockUndo& blockUndo)
+{
+    if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+        return error("%s: failed to read block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    CDiskBlockPos pos = pindex->GetUndoPos();
+    if (pos.IsNull()) {
+        return error("%s: no undo data available for block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    if (!UndoReadFromDisk(blockUndo, pos, pindex->pprev->GetBlockHash())) {
+        return error("%s: failed to read undo data of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    if (blockUndo.vtxundo.size() + 1 != block.vtx.size()) {
+        return error("%s: block %s and undo data inconsistent", __func__, pindex->GetBlockHash().ToString());
+    }
+    return true;
+}
+
+bool CIndexer::GetConnectEntries(const CBlockIndex* pindex, BlockIndexEntries& entries)
+{
+    // the transactions of the genesis block are not connected
+    if (pindex->pprev == nullptr) {
+        return true;
+    }
+
+    CBlock block;
+    CBlockUndo blockUndo;
+    if (!ReadBlockAndUndo(pindex, block, blockUndo)) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        const uint256 txhash = tx.GetHash();
+
+        if (!tx.IsCoinBase() && (fAddressIndex || fSpentIndex)) {
+            const CTxUndo& txundo = blockUndo.vtxundo[i - 1];
+            if (txundo.vprevout.size() != tx.vin.size()) {
+                return error("%s: transaction %s and undo data inconsistent", __func__, txhash.ToString());
+            }
+            for (size_t j = 0; j < tx.vin.size(); j++) {
+                const CTxIn& input = tx.vin[j];
+                const CTxOut& prevout = txundo.vprevout[j].out;
+                uint160 hashBytes;
+                int addressType = GetScriptAddress(prevout.scriptPubKey, hashBytes);
+
+                if (fAddressIndex && addressType > 0) {
+                    // record spending activity
+                    entries.addressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, j, true), prevout.nValue * -1);
+
+                    // remove address from unspent index
+                    entries.addressUnspentIndex.emplace_back(CAddressUnspentKey(addressType, hashBytes, input.prevout.hash, input.prevout.n), CAddressUnspentValue());
+                }
+
+                if (fSpentIndex) {
+                    // add the spent index to determine the txid and input that spent an output
+                    // and to find the amount and address from an input
+                    entries.spentIndex.emplace_back(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(txhash, j, pindex->nHeight, prevout.nValue, addressType, hashBytes));
+                }
+            }
+        }
+
+        if (fAddressIndex) {
+            for (unsigned int k = 0; k < tx.vout.size(); k++) {
+                const CTxOut& out = tx.vout[k];
+                uint160 hashBytes;
+                int addressType = GetScriptAddress(out.scriptPubKey, hashBytes);
+                if (addressType == 0) {
+                    continue;
+                }
+
+                // record receiving activity
+                entries.addressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, k, false), out.nValue);
+
+                // record unspent output
+                entries.addressUnspentIndex.emplace_back(CAddressUnspentKey(addressType, hashBytes, txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight));
+            }
+        }
+    }
+
+    return true;
+}
+
+bool CIndexer::GetDisconnectEntries(const CBlockIndex* pindex, BlockIndexEntries& entries)
+{
+    CBlock block;
+    CBlockUndo blockUndo;
+    if (!ReadBlockAndUndo(pindex, block, blockUndo)) {
+        return false;
+    }
+
+    // undo transactions in reverse order
+    for (int i = block.vtx.size() - 1; i >= 0; i--) {
+        const CTransaction& tx = *block.vtx[i];
+        const uint256 txhash = tx.GetHash();
+
+        if (fAddressIndex) {
+            for (unsigned int k = tx.vout.size(); k-- > 0;) {
+                const CTxOut& out = tx.vout[k];
+                uint160 hashBytes;
+                int addressType = GetScriptAddress(out.scriptPubKey, hashBytes);
+                if (addressType == 0) {
+                    continue;
+                }
+
+                // undo receiving activity
+                entries.addressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, k, false), out.nValue);
+
+                // undo unspent index
+                entries.addressUnspentIndex.emplace_back(CAddressUnspentKey(addressType, hashBytes, txhash, k), CAddressUnspentValue());
+            }
+        }
+
+        if (i > 0 && (fAddressIndex || fSpentIndex)) {
+            const CTxUndo& txundo = blockUndo.vtxundo[i - 1];
+            if (txundo.vprevout.size() != tx.vin.size()) {
+                return error("%s: transaction %s and undo data inconsistent", __func__, txhash.ToString());
+            }
+            for (unsigned int j = tx.vin.size(); j-- > 0;) {
+                const CTxIn& input = tx.vin[j];
+                const Coin& coin = txundo.vprevout[j];
+                const CTxOut& prevout = coin.out;
+
+                if (fSpentIndex) {
+                    // undo and delete the spent index
+                    entries.spentIndex.emplace_back(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue());
+                }
+
+                uint160 hashBytes;
+                int addressType = GetScriptAddress(prevout.scriptPubKey, hashBytes);
+                if (fAddressIndex && addressType > 0) {
+                    // undo spending activity
+                    entries.addressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, j, true), prevout.nValue * -1);
+
+                    // restore unspent index
+                    entries.addressUnspentIndex.emplace_back(CAddressUnspentKey(addressType, hashBytes, input.prevout.hash, input.prevout.n), CAddressUnspentValue(prevout.nValue, prevout.scriptPubKey, coin.nHeight));
+                }
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DASH_INDEXER_H
+#define DASH_INDEXER_H
+
+#include "amount.h"
+#include "ctpl.h"
+#include "spentindex.h"
+#include "validationinterface.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+
+/**
+ * Maintains the address, spent and timestamp indexes (-addressindex, -spentindex, -timestampindex) in the background.
+ *
+ * The indexer follows the active chain on its own thread, so that ConnectBlock and DisconnectBlock don't have to
+ * compute and write index entries while holding cs_main. Block (dis)connect notifications only wake up the thread.
+ * Entries are computed from the block and its undo data. While the indexer is behind the tip (e.g. while syncing or
+ * during -reindex), the entries of many blocks are computed in parallel and written in large batches.
+ *
+ * The hash of the last indexed block is written in the same batch as the index entries, so that a block is never
+ * applied twice or only partially to the indexes after a crash.
+ */
+class CIndexer : public CValidationInterface
+{
+private:
+    // Index entries of a single block, in the order in which they must be applied
+    struct BlockIndexEntries {
+        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
+        std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
+    };
+
+    ctpl::thread_pool workerPool;
+    std::thread workThread;
+
+    std::mutex cs;
+    std::condition_variable cvWork;
+    std::condition_variable cvFlushed;
+    bool fInterrupted{false};
+    bool fWorkPending{false};
+    // The last block whose entries were written to disk
+    const CBlockIndex* pindexFlushed{nullptr};
+
+    // Set once the indexer caught up with the active chain for the first time
+    std::atomic<bool> fSynced{false};
+
+    // The last block which was applied to the indexes. Only accessed by the indexer thread after Start()
+    const CBlockIndex* pindexBest{nullptr};
+
+public:
+    CIndexer();
+    ~CIndexer();
+
+    // Loads the last indexed block. Must be called before Start()
+    bool Init();
+
+    void Start();
+    void Interrupt();
+    // Stops the indexer thread and writes all pending index entries. Call Interrupt() first
+    void Stop();
+
+    /**
+     * Blocks until the indexes contain all blocks of the active chain at the time of the call, so that RPCs see the
+     * blocks they just mined or received. Returns immediately while the indexer is still catching up with the chain
+     * or during initial block download, as pending entries are only written in large batches then.
+     * Must not be called with cs_main held.
+     */
+    void BlockUntilSyncedToCurrentChain();
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindexDisconnected) override;
+
+private:
+    void WakeUp();
+    void ThreadIndexer();
+
+    bool ConnectBlocks(const std::vector<const CBlockIndex*>& vpindex);
+    bool DisconnectBlock(const CBlockIndex* pindex);
+    bool Flush();
+
+    static bool ReadBlockAndUndo(const CBlockIndex* pindex, CBlock& block, CBlockUndo& blockUndo);
+    static bool GetConnectEntries(const CBlockIndex* pindex, BlockIndexEntries& entries);
+    static bool GetDisconnectEntries(const CBlockIndex* pindex, BlockIndexEntries& entries);
+};
+
+extern std::unique_ptr<CIndexer> g_indexer;
+
+#endif // DASH_INDEXER_H
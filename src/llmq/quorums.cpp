@@ -26,6 +26,7 @@ namespace llmq
 
 static const std::string DB_QUORUM_SK_SHARE = "q_Qsk";
 static const std::string DB_QUORUM_QUORUM_VVEC = "q_Qqvvec";
+static const std::string DB_QUORUM_PUBKEY_SHARES = "q_Qpkshares";
 
 CQuorumManager* quorumManager;
 
@@ -84,6 +85,12 @@ CBLSPublicKey CQuorum::GetPubKeyShare(size_t memberIdx) const
     if (quorumVvec == nullptr || memberIdx >= members.size() || !qc.validMembers[memberIdx]) {
         return CBLSPublicKey();
     }
+    {
+        LOCK(cs);
+        if (!pubKeyShares.empty()) {
+            return pubKeyShares[memberIdx];
+        }
+    }
     auto& m = members[memberIdx];
     return blsCache.BuildPubKeyShare(m->proTxHash, quorumVvec, CBLSId::FromHash(m->proTxHash));
 }
@@ -133,7 +140,31 @@ bool CQuorum::ReadContributions(CEvoDB& evoDb)
     return true;
 }
 
-void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this)
+void CQuorum::WritePubKeyShares(CEvoDB& evoDb, std::vector<CBLSPublicKey>&& _pubKeyShares)
+{
+    uint256 dbKey = MakeQuorumKey(*this);
+
+    evoDb.GetRawDB().Write(std::make_pair(DB_QUORUM_PUBKEY_SHARES, dbKey), _pubKeyShares);
+
+    LOCK(cs);
+    pubKeyShares = std::move(_pubKeyShares);
+}
+
+bool CQuorum::ReadPubKeyShares(CEvoDB& evoDb)
+{
+    uint256 dbKey = MakeQuorumKey(*this);
+
+    std::vector<CBLSPublicKey> v;
+    if (!evoDb.Read(std::make_pair(DB_QUORUM_PUBKEY_SHARES, dbKey), v) || v.size() != members.size()) {
+        return false;
+    }
+
+    LOCK(cs);
+    pubKeyShares = std::move(v);
+    return true;
+}
+
+void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this, CEvoDB& evoDb)
 {
     if (_this->quorumVvec == nullptr) {
         return;
@@ -144,13 +175,41 @@ void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this)
 
     // this thread will exit after some time
     // when then later some other thread tries to get keys, it will be much faster
-    _this->cachePopulatorThread = std::thread([_this, t]() {
+    _this->cachePopulatorThread = std::thread([_this, t, &evoDb]() {
         RenameThread("dash-q-cachepop");
-        for (size_t i = 0; i < _this->members.size() && !_this->stopCachePopulatorThread && !ShutdownRequested(); i++) {
+
+        // public key shares are persisted after they were computed the first time, so that we don't have to do it again
+        // after every restart
+        if (_this->ReadPubKeyShares(evoDb)) {
+            LogPrint(BCLog::LLMQ, "CQuorum::StartCachePopulatorThread -- loaded public key shares. time=%d\n", t.count());
+            return;
+        }
+
+        // calculate the shares of the valid members in batches on the worker pool. CQuorumManager::Stop() joins this
+        // thread before the worker pool is stopped on shutdown, so we only need to check for the stop flag in between
+        static const size_t BATCH_SIZE = 64;
+        BLSIdVector ids;
+        std::vector<size_t> memberIndexes;
+        for (size_t i = 0; i < _this->members.size(); i++) {
             if (_this->qc.validMembers[i]) {
-                _this->GetPubKeyShare(i);
+                ids.emplace_back(CBLSId::FromHash(_this->members[i]->proTxHash));
+                memberIndexes.emplace_back(i);
             }
         }
+
+        std::vector<CBLSPublicKey> shares(_this->members.size());
+        for (size_t i = 0; i < ids.size(); i += BATCH_SIZE) {
+            if (_this->stopCachePopulatorThread || ShutdownRequested()) {
+                return;
+            }
+            size_t count = std::min(BATCH_SIZE, ids.size() - i);
+            BLSIdVector batchIds(ids.begin() + i, ids.begin() + i + count);
+            auto batchShares = _this->blsWorker.BuildAllPubKeyShares(_this->quorumVvec, batchIds, true);
+            for (size_t j = 0; j < count; j++) {
+                shares[memberIndexes[i + j]] = batchShares[j];
+            }
+        }
+        _this->WritePubKeyShares(evoDb, std::move(shares));
         LogPrint(BCLog::LLMQ, "CQuorum::StartCachePopulatorThread -- done. time=%d\n", t.count());
     });
 }
@@ -162,6 +221,20 @@ CQuorumManager::CQuorumManager(CEvoDB& _evoDb, CBLSWorker& _blsWorker, CDKGSessi
 {
 }
 
+void CQuorumManager::Stop()
+{
+    LOCK(quorumsCacheCs);
+    cachePopulatorsStopped = true;
+    // the cache populator threads use the BLS worker pool, so they must be finished before the pool is stopped
+    for (auto& p : quorumsCache) {
+        auto& quorum = p.second;
+        quorum->stopCachePopulatorThread = true;
+        if (quorum->cachePopulatorThread.joinable()) {
+            quorum->cachePopulatorThread.join();
+        }
+    }
+}
+
 void CQuorumManager::UpdatedBlockTip(const CBlockIndex* pindexNew, bool fInitialDownload)
 {
     if (!masternodeSync.IsBlockchainSynced()) {
@@ -249,11 +322,11 @@ bool CQuorumManager::BuildQuorumFromCommitment(const CFinalCommitment& qc, const
         }
     }
 
-    if (hasValidVvec) {
+    if (hasValidVvec && !cachePopulatorsStopped) {
         // pre-populate caches in the background
         // recovering public key shares is quite expensive and would result in serious lags for the first few signing
         // sessions if the shares would be calculated on-demand
-        CQuorum::StartCachePopulatorThread(quorum);
+        CQuorum::StartCachePopulatorThread(quorum, evoDb);
     }
 
     return true;
@@ -48,12 +48,17 @@ public:
 private:
     // Recovery of public key shares is very slow, so we start a background thread that pre-populates a cache so that
     // the public key shares are ready when needed later
+    CBLSWorker& blsWorker;
     mutable CBLSWorkerCache blsCache;
+    // All public key shares (indexed by member index) once they were either computed completely or loaded from evodb.
+    // Empty until then, in which case blsCache is used
+    mutable CCriticalSection cs;
+    std::vector<CBLSPublicKey> pubKeyShares;
     std::atomic<bool> stopCachePopulatorThread;
     std::thread cachePopulatorThread;
 
 public:
-    CQuorum(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker) : params(_params), blsCache(_blsWorker), stopCachePopulatorThread(false) {}
+    CQuorum(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker) : params(_params), blsWorker(_blsWorker), blsCache(_blsWorker), stopCachePopulatorThread(false) {}
     ~CQuorum();
     void Init(const CFinalCommitment& _qc, const CBlockIndex* _pindexQuorum, const uint256& _minedBlockHash, const std::vector<CDeterministicMNCPtr>& _members);
 
@@ -67,7 +72,9 @@ public:
 private:
     void WriteContributions(CEvoDB& evoDb);
     bool ReadContributions(CEvoDB& evoDb);
-    static void StartCachePopulatorThread(std::shared_ptr<CQuorum> _this);
+    void WritePubKeyShares(CEvoDB& evoDb, std::vector<CBLSPublicKey>&& _pubKeyShares);
+    bool ReadPubKeyShares(CEvoDB& evoDb);
+    static void StartCachePopulatorThread(std::shared_ptr<CQuorum> _this, CEvoDB& evoDb);
 };
 typedef std::shared_ptr<CQuorum> CQuorumPtr;
 typedef std::shared_ptr<const CQuorum> CQuorumCPtr;
@@ -88,10 +95,15 @@ private:
     CCriticalSection quorumsCacheCs;
     std::map<std::pair<Consensus::LLMQType, uint256>, CQuorumPtr> quorumsCache;
     unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, std::vector<CQuorumCPtr>, StaticSaltedHasher, 32> scanQuorumsCache;
+    // set on shutdown, no cache populator threads are started afterwards
+    bool cachePopulatorsStopped{false};
 
 public:
     CQuorumManager(CEvoDB& _evoDb, CBLSWorker& _blsWorker, CDKGSessionManager& _dkgManager);
 
+    // stops and joins all cache populator threads
+    void Stop();
+
     void UpdatedBlockTip(const CBlockIndex *pindexNew, bool fInitialDownload);
 
     bool HasQuorum(Consensus::LLMQType llmqType, const uint256& quorumHash);
@@ -107,6 +119,7 @@ private:
     // all private methods here are cs_main-free
     void EnsureQuorumConnections(Consensus::LLMQType llmqType, const CBlockIndex *pindexNew);
 
+    // must be called with quorumsCacheCs held
     bool BuildQuorumFromCommitment(const CFinalCommitment& qc, const CBlockIndex* pindexQuorum, const uint256& minedBlockHash, std::shared_ptr<CQuorum>& quorum) const;
     bool BuildQuorumContributions(const CFinalCommitment& fqc, std::shared_ptr<CQuorum>& quorum) const;
 
@@ -23,6 +23,10 @@ static const std::string CLSIG_REQUESTID_PREFIX = "clsig";
 
 CChainLocksHandler* chainLocksHandler;
 
+static int64_t nTimeEnforcePrepare = 0;
+static int64_t nTimeEnforceInvalidate = 0;
+static int64_t nTimeEnforceActivate = 0;
+
 bool CChainLockSig::IsNull() const
 {
     return nHeight == -1 && blockHash == uint256();
@@ -44,6 +48,17 @@ CChainLocksHandler::~CChainLocksHandler()
 
 void CChainLocksHandler::Start()
 {
+    {
+        // Headers which are already known are not tracked in blockIndexByPrev, so FindConflictingBlocks has to fall
+        // back to mapPrevBlockIndex for everything up to the highest known header
+        LOCK2(cs_main, cs);
+        int maxHeight = -1;
+        for (const auto& p : mapBlockIndex) {
+            maxHeight = std::max(maxHeight, p.second->nHeight);
+        }
+        blockIndexByPrevMinHeight = maxHeight + 1;
+    }
+
     quorumSigningManager->RegisterRecoveredSigsListener(this);
     scheduler->scheduleEvery([&]() {
         CheckActiveState();
@@ -165,10 +180,7 @@ void CChainLocksHandler::ProcessNewChainLock(NodeId from, const llmq::CChainLock
         bestChainLockBlockIndex = pindex;
     }
 
-    scheduler->scheduleFromNow([&]() {
-        CheckActiveState();
-        EnforceBestChainLock();
-    }, 0);
+    ScheduleEnforceBestChainLock();
 
     LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- processed new CLSIG (%s), peer=%d\n",
               __func__, clsig.ToString(), from);
@@ -178,6 +190,10 @@ void CChainLocksHandler::AcceptedBlockHeader(const CBlockIndex* pindexNew)
 {
     LOCK2(cs_main, cs);
 
+    if (pindexNew->pprev && pindexNew->nHeight >= blockIndexByPrevMinHeight) {
+        blockIndexByPrev.emplace(pindexNew->pprev->GetBlockHash(), pindexNew);
+    }
+
     if (pindexNew->GetBlockHash() == bestChainLock.blockHash) {
         LogPrintf("CChainLocksHandler::%s -- block header %s came in late, updating and enforcing\n", __func__, pindexNew->GetBlockHash().ToString());
 
@@ -215,6 +231,25 @@ void CChainLocksHandler::UpdatedBlockTip(const CBlockIndex* pindexNew)
     }, 0);
 }
 
+void CChainLocksHandler::ScheduleEnforceBestChainLock()
+{
+    // Enforcement is never done directly from the calling thread but always handed over to the scheduler. Multiple
+    // new CLSIGs arriving before the scheduler gets to it result in a single enforcement run.
+    LOCK(cs);
+    if (enforceBestChainLockScheduled) {
+        return;
+    }
+    enforceBestChainLockScheduled = true;
+    scheduler->scheduleFromNow([&]() {
+        {
+            LOCK(cs);
+            enforceBestChainLockScheduled = false;
+        }
+        CheckActiveState();
+        EnforceBestChainLock();
+    }, 0);
+}
+
 void CChainLocksHandler::CheckActiveState()
 {
     bool fDIP0008Active;
@@ -312,27 +347,14 @@ void CChainLocksHandler::TrySignChainTip()
                 break;
             }
 
-            auto txids = GetBlockTxs(pindexWalk->GetBlockHash());
-            if (!txids) {
+            auto txs = GetBlockTxs(pindexWalk->GetBlockHash());
+            if (!txs) {
                 pindexWalk = pindexWalk->pprev;
                 continue;
             }
 
-            for (auto& txid : *txids) {
-                int64_t txAge = 0;
-                {
-                    LOCK(cs);
-                    auto it = txFirstSeenTime.find(txid);
-                    if (it != txFirstSeenTime.end()) {
-                        txAge = GetAdjustedTime() - it->second;
-                    }
-                }
-
-                if (txAge < WAIT_FOR_ISLOCK_TIMEOUT && !quorumInstantSendManager->IsLocked(txid)) {
-                    LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- not signing block %s due to TX %s not being ixlocked and not old enough. age=%d\n", __func__,
-                              pindexWalk->GetBlockHash().ToString(), txid.ToString(), txAge);
-                    return;
-                }
+            if (!IsBlockSafe(pindexWalk, txs)) {
+                return;
             }
 
             pindexWalk = pindexWalk->pprev;
@@ -362,7 +384,6 @@ void CChainLocksHandler::TransactionAddedToMempool(const CTransactionRef& tx, in
         return;
     }
 
-    LOCK(cs);
     txFirstSeenTime.emplace(tx->GetHash(), nAcceptTime);
 }
 
@@ -374,84 +395,96 @@ void CChainLocksHandler::BlockConnected(const std::shared_ptr<const CBlock>& pbl
 
     // We listen for BlockConnected so that we can collect all TX ids of all included TXs of newly received blocks
     // We need this information later when we try to sign a new tip, so that we can determine if all included TXs are
-    // safe.
+    // safe. Most TXs are already ixlocked at this point, so TrySignChainTip will only have to look at the few
+    // remaining ones.
 
-    LOCK(cs);
-
-    auto it = blockTxs.find(pindex->GetBlockHash());
-    if (it == blockTxs.end()) {
-        // we must create this entry even if there are no lockable transactions in the block, so that TrySignChainTip
-        // later knows about this block
-        it = blockTxs.emplace(pindex->GetBlockHash(), std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>()).first;
+    if (blockTxs.exists(pindex->GetBlockHash())) {
+        return;
     }
-    auto& txids = *it->second;
 
-    int64_t curTime = GetAdjustedTime();
+    // we must create this entry even if there are no lockable transactions in the block, so that TrySignChainTip
+    // later knows about this block
+    blockTxs.emplace(pindex->GetBlockHash(), CreateBlockTxs(*pblock, GetAdjustedTime()));
+}
+
+void CChainLocksHandler::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
+{
+    blockTxs.erase(pindexDisconnected->GetBlockHash());
+}
+
+CChainLocksHandler::BlockTxsInfoPtr CChainLocksHandler::CreateBlockTxs(const CBlock& block, int64_t firstSeenTime)
+{
+    AssertLockNotHeld(cs);
 
-    for (const auto& tx : pblock->vtx) {
+    auto ret = std::make_shared<BlockTxsInfo>();
+    for (const auto& tx : block.vtx) {
         if (tx->IsCoinBase() || tx->vin.empty()) {
             continue;
         }
 
-        txids.emplace(tx->GetHash());
-        txFirstSeenTime.emplace(tx->GetHash(), curTime);
+        const auto& txid = tx->GetHash();
+        ret->txids.emplace(txid);
+        txFirstSeenTime.emplace(txid, firstSeenTime);
     }
-
-}
-
-void CChainLocksHandler::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
-{
-    LOCK(cs);
-    blockTxs.erase(pindexDisconnected->GetBlockHash());
+    return ret;
 }
 
-CChainLocksHandler::BlockTxs::mapped_type CChainLocksHandler::GetBlockTxs(const uint256& blockHash)
+CChainLocksHandler::BlockTxsInfoPtr CChainLocksHandler::GetBlockTxs(const uint256& blockHash)
 {
     AssertLockNotHeld(cs);
     AssertLockNotHeld(cs_main);
 
-    CChainLocksHandler::BlockTxs::mapped_type ret;
+    BlockTxsInfoPtr ret;
+    if (blockTxs.get(blockHash, ret)) {
+        return ret;
+    }
 
+    // This should only happen when freshly started.
+    // If running for some time, SyncTransaction should have been called before which fills blockTxs.
+    LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- blockTxs for %s not found. Trying ReadBlockFromDisk\n", __func__,
+             blockHash.ToString());
+
+    CBlock block;
     {
-        LOCK(cs);
-        auto it = blockTxs.find(blockHash);
-        if (it != blockTxs.end()) {
-            ret = it->second;
+        LOCK(cs_main);
+        auto pindex = mapBlockIndex.at(blockHash);
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            return nullptr;
         }
     }
-    if (!ret) {
-        // This should only happen when freshly started.
-        // If running for some time, SyncTransaction should have been called before which fills blockTxs.
-        LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- blockTxs for %s not found. Trying ReadBlockFromDisk\n", __func__,
-                 blockHash.ToString());
 
-        uint32_t blockTime;
-        {
-            LOCK(cs_main);
-            auto pindex = mapBlockIndex.at(blockHash);
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-                return nullptr;
-            }
+    ret = CreateBlockTxs(block, block.nTime);
+    if (!blockTxs.emplace(blockHash, ret)) {
+        // BlockConnected was faster
+        blockTxs.get(blockHash, ret);
+    }
+    return ret;
+}
 
-            ret = std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>();
-            for (auto& tx : block.vtx) {
-                if (tx->IsCoinBase() || tx->vin.empty()) {
-                    continue;
-                }
-                ret->emplace(tx->GetHash());
-            }
+bool CChainLocksHandler::IsTxSafe(const uint256& txid, int64_t curTime, int64_t& retTxAge)
+{
+    retTxAge = 0;
+    int64_t firstSeenTime;
+    if (txFirstSeenTime.get(txid, firstSeenTime)) {
+        retTxAge = curTime - firstSeenTime;
+    }
 
-            blockTime = block.nTime;
-        }
+    return retTxAge >= WAIT_FOR_ISLOCK_TIMEOUT || quorumInstantSendManager->IsLocked(txid);
+}
 
-        LOCK(cs);
-        blockTxs.emplace(blockHash, ret);
-        for (auto& txid : *ret) {
-            txFirstSeenTime.emplace(txid, blockTime);
+bool CChainLocksHandler::IsBlockSafe(const CBlockIndex* pindex, const BlockTxsInfoPtr& txs)
+{
+    int64_t curTime = GetAdjustedTime();
+
+    for (const auto& txid : txs->txids) {
+        int64_t txAge;
+        if (!IsTxSafe(txid, curTime, txAge)) {
+            LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- not signing block %s due to TX %s not being ixlocked and not old enough. age=%d\n", __func__,
+                      pindex->GetBlockHash().ToString(), txid.ToString(), txAge);
+            return false;
         }
     }
-    return ret;
+    return true;
 }
 
 bool CChainLocksHandler::IsTxSafeForMining(const uint256& txid)
@@ -463,22 +496,53 @@ bool CChainLocksHandler::IsTxSafeForMining(const uint256& txid)
         return true;
     }
 
-    int64_t txAge = 0;
     {
         LOCK(cs);
         if (!isSporkActive) {
             return true;
         }
-        auto it = txFirstSeenTime.find(txid);
-        if (it != txFirstSeenTime.end()) {
-            txAge = GetAdjustedTime() - it->second;
-        }
     }
 
-    if (txAge < WAIT_FOR_ISLOCK_TIMEOUT && !quorumInstantSendManager->IsLocked(txid)) {
-        return false;
+    int64_t txAge;
+    return IsTxSafe(txid, GetAdjustedTime(), txAge);
+}
+
+// Go backwards through the chain referenced by the CLSIG until we find a block that is part of the chain ending in
+// pindexTip. For each of these blocks, collect the children of its parent that are NOT part of the chain referenced by
+// the CLSIG. The block that forks off the active chain (if any) comes last.
+// pprev, pskip and nHeight of a CBlockIndex never change once it is in mapBlockIndex, so the chain itself is walked
+// without cs_main. Children are looked up in blockIndexByPrev and only untracked (old) heights need cs_main.
+std::vector<const CBlockIndex*> CChainLocksHandler::FindConflictingBlocks(const CBlockIndex* pindex, const CBlockIndex* pindexTip)
+{
+    AssertLockNotHeld(cs);
+
+    std::vector<const CBlockIndex*> ret;
+    auto collect = [&](const std::pair<uint256, const CBlockIndex*>& p) {
+        // All blocks that have the same prevBlockHash but are not equal to blockHash are conflicting
+        if (p.second != pindex) {
+            ret.emplace_back(p.second);
+        }
+    };
+    while (pindex && pindexTip->GetAncestor(pindex->nHeight) != pindex) {
+        const uint256& prevBlockHash = pindex->pprev->GetBlockHash();
+        bool fTracked;
+        {
+            LOCK(cs);
+            fTracked = pindex->nHeight >= blockIndexByPrevMinHeight;
+            if (fTracked) {
+                auto itp = blockIndexByPrev.equal_range(prevBlockHash);
+                std::for_each(itp.first, itp.second, collect);
+            }
+        }
+        if (!fTracked) {
+            LOCK(cs_main);
+            auto itp = mapPrevBlockIndex.equal_range(prevBlockHash);
+            std::for_each(itp.first, itp.second, collect);
+        }
+
+        pindex = pindex->pprev;
     }
-    return true;
+    return ret;
 }
 
 // WARNING: cs_main and cs should not be held!
@@ -504,27 +568,39 @@ void CChainLocksHandler::EnforceBestChainLock()
         }
     }
 
-    bool activateNeeded;
+    int64_t nTime1 = GetTimeMicros();
+
+    // Stage 1: Collect the blocks which conflict with the CLSIG. cs_main is only needed to get the current tip, the
+    // search itself works on the handler's own header index.
+    const CBlockIndex* pindexTip;
     {
         LOCK(cs_main);
+        pindexTip = chainActive.Tip();
+    }
+    std::vector<const CBlockIndex*> conflictingBlocks = FindConflictingBlocks(pindex, pindexTip);
 
-        // Go backwards through the chain referenced by clsig until we find a block that is part of the main chain.
-        // For each of these blocks, check if there are children that are NOT part of the chain referenced by clsig
-        // and invalidate each of them.
-        while (pindex && !chainActive.Contains(pindex)) {
-            // Invalidate all blocks that have the same prevBlockHash but are not equal to blockHash
-            auto itp = mapPrevBlockIndex.equal_range(pindex->pprev->GetBlockHash());
-            for (auto jt = itp.first; jt != itp.second; ++jt) {
-                if (jt->second == pindex) {
-                    continue;
-                }
-                LogPrintf("CChainLocksHandler::%s -- CLSIG (%s) invalidates block %s\n",
-                          __func__, clsig.ToString(), jt->second->GetBlockHash().ToString());
-                DoInvalidateBlock(jt->second, false);
-            }
+    int64_t nTime2 = GetTimeMicros(); nTimeEnforcePrepare += nTime2 - nTime1;
 
-            pindex = pindex->pprev;
+    // Stage 2: Invalidate the conflicting blocks. Every block gets its own cs_main section, so that block and
+    // message processing can continue in between. Same as before, blocks which are only marked as BLOCK_FAILED_CHILD
+    // are invalidated again. Blocks which are already BLOCK_FAILED_VALID (e.g. by an earlier run) are skipped, as
+    // invalidating them again would not change anything. If the active chain moves to a conflicting block which was
+    // not seen here, the next UpdatedBlockTip will schedule another enforcement run.
+    size_t invalidatedCount = 0;
+    for (auto pindexConflict : conflictingBlocks) {
+        LOCK(cs_main);
+        if (pindexConflict->nStatus & BLOCK_FAILED_VALID) {
+            continue;
         }
+        LogPrintf("CChainLocksHandler::%s -- CLSIG (%s) invalidates block %s\n",
+                  __func__, clsig.ToString(), pindexConflict->GetBlockHash().ToString());
+        DoInvalidateBlock(pindexConflict, false);
+        invalidatedCount++;
+    }
+
+    bool activateNeeded;
+    {
+        LOCK(cs_main);
         // In case blocks from the correct chain are invalid at the moment, reconsider them. The only case where this
         // can happen right now is when missing superblock triggers caused the main chain to be dismissed first. When
         // the trigger later appears, this should bring us to the correct chain eventually. Please note that this does
@@ -536,11 +612,25 @@ void CChainLocksHandler::EnforceBestChainLock()
         activateNeeded = chainActive.Tip()->GetAncestor(currentBestChainLockBlockIndex->nHeight) != currentBestChainLockBlockIndex;
     }
 
+    int64_t nTime3 = GetTimeMicros(); nTimeEnforceInvalidate += nTime3 - nTime2;
+
+    // Stage 3: Switch to the CLSIG locked chain. ActivateBestChain releases cs_main between connecting blocks, so
+    // normal block processing can interleave with this.
     CValidationState state;
     if (activateNeeded && !ActivateBestChain(state, Params())) {
         LogPrintf("CChainLocksHandler::%s -- ActivateBestChain failed: %s\n", __func__, FormatStateMessage(state));
     }
 
+    int64_t nTime4 = GetTimeMicros(); nTimeEnforceActivate += nTime4 - nTime3;
+
+    if (!conflictingBlocks.empty() || activateNeeded) {
+        LogPrint(BCLog::BENCHMARK, "CChainLocksHandler::%s -- enforced CLSIG (%s): invalidated %d of %d conflicting blocks\n", __func__,
+                 clsig.ToString(), invalidatedCount, conflictingBlocks.size());
+        LogPrint(BCLog::BENCHMARK, "    - Find conflicting blocks: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), nTimeEnforcePrepare * 0.000001);
+        LogPrint(BCLog::BENCHMARK, "    - Invalidate blocks: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeEnforceInvalidate * 0.000001);
+        LogPrint(BCLog::BENCHMARK, "    - Activate best chain: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeEnforceActivate * 0.000001);
+    }
+
     const CBlockIndex* pindexNotify = nullptr;
     {
         LOCK(cs_main);
@@ -695,35 +785,52 @@ void CChainLocksHandler::Cleanup()
         }
     }
 
-    for (auto it = blockTxs.begin(); it != blockTxs.end(); ) {
-        auto pindex = mapBlockIndex.at(it->first);
-        if (InternalHasChainLock(pindex->nHeight, pindex->GetBlockHash())) {
-            for (auto& txid : *it->second) {
-                txFirstSeenTime.erase(txid);
+    // Conflicts are only searched above the last chainlocked block of the active chain, so children of older blocks
+    // don't need to be tracked anymore
+    if (lastNotifyChainLockBlockIndex && lastNotifyChainLockBlockIndex->nHeight >= blockIndexByPrevMinHeight) {
+        blockIndexByPrevMinHeight = lastNotifyChainLockBlockIndex->nHeight + 1;
+        for (auto it = blockIndexByPrev.begin(); it != blockIndexByPrev.end(); ) {
+            if (it->second->nHeight < blockIndexByPrevMinHeight) {
+                it = blockIndexByPrev.erase(it);
+            } else {
+                ++it;
             }
-            it = blockTxs.erase(it);
-        } else if (InternalHasConflictingChainLock(pindex->nHeight, pindex->GetBlockHash())) {
-            it = blockTxs.erase(it);
-        } else {
-            ++it;
         }
     }
-    for (auto it = txFirstSeenTime.begin(); it != txFirstSeenTime.end(); ) {
+
+    std::vector<uint256> chainLockedTxids;
+    blockTxs.erase_if([&](const uint256& blockHash, const BlockTxsInfoPtr& txs) {
+        auto pindex = mapBlockIndex.at(blockHash);
+        if (InternalHasChainLock(pindex->nHeight, pindex->GetBlockHash())) {
+            chainLockedTxids.insert(chainLockedTxids.end(), txs->txids.begin(), txs->txids.end());
+            return true;
+        }
+        return InternalHasConflictingChainLock(pindex->nHeight, pindex->GetBlockHash());
+    });
+    for (auto& txid : chainLockedTxids) {
+        txFirstSeenTime.erase(txid);
+    }
+    // GetTransaction might hit the disk, so it's not called while a shard is locked. Entries which were added again
+    // in the meantime have a different first-seen time and are kept
+    for (const auto& p : txFirstSeenTime.snapshot()) {
+        const uint256& txid = p.first;
         CTransactionRef tx;
         uint256 hashBlock;
-        if (!GetTransaction(it->first, tx, Params().GetConsensus(), hashBlock)) {
+        bool fErase = false;
+        if (!GetTransaction(txid, tx, Params().GetConsensus(), hashBlock)) {
             // tx has vanished, probably due to conflicts
-            it = txFirstSeenTime.erase(it);
+            fErase = true;
         } else if (!hashBlock.IsNull()) {
             auto pindex = mapBlockIndex.at(hashBlock);
             if (chainActive.Tip()->GetAncestor(pindex->nHeight) == pindex && chainActive.Height() - pindex->nHeight >= 6) {
                 // tx got confirmed >= 6 times, so we can stop keeping track of it
-                it = txFirstSeenTime.erase(it);
-            } else {
-                ++it;
+                fErase = true;
             }
-        } else {
-            ++it;
+        }
+        if (fErase) {
+            txFirstSeenTime.update_erase_if(txid, [&](int64_t firstSeenTime) {
+                return firstSeenTime == p.second;
+            });
         }
     }
 
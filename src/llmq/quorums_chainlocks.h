@@ -10,8 +10,12 @@
 
 #include "net.h"
 #include "chainparams.h"
+#include "saltedhasher.h"
+#include "sharded_map.h"
 
 #include <atomic>
+#include <limits>
+#include <unordered_map>
 #include <unordered_set>
 
 class CBlockIndex;
@@ -54,6 +58,7 @@ private:
     CScheduler* scheduler;
     CCriticalSection cs;
     bool tryLockChainTipScheduled{false};
+    bool enforceBestChainLockScheduled{false};
     bool isSporkActive{false};
     bool isEnforced{false};
 
@@ -64,14 +69,28 @@ private:
     const CBlockIndex* bestChainLockBlockIndex{nullptr};
     const CBlockIndex* lastNotifyChainLockBlockIndex{nullptr};
 
+    // Children of recently accepted block headers, keyed by the hash of their parent. This allows to find the blocks
+    // which conflict with a CLSIG without holding cs_main. Headers below blockIndexByPrevMinHeight are not tracked
+    // (they were accepted before Start() or were pruned by Cleanup), so mapPrevBlockIndex is used for these instead.
+    std::unordered_multimap<uint256, const CBlockIndex*, StaticSaltedHasher> blockIndexByPrev;
+    int blockIndexByPrevMinHeight{std::numeric_limits<int>::max()};
+
     int32_t lastSignedHeight{-1};
     uint256 lastSignedRequestId;
     uint256 lastSignedMsgHash;
 
     // We keep track of txids from recently received blocks so that we can check if all TXs got ixlocked
-    typedef std::unordered_map<uint256, std::shared_ptr<std::unordered_set<uint256, StaticSaltedHasher>>> BlockTxs;
-    BlockTxs blockTxs;
-    std::unordered_map<uint256, int64_t> txFirstSeenTime;
+    struct BlockTxsInfo {
+        // Not modified after creation. All TXs are checked again on every signing attempt, as islocks can be removed
+        // and first-seen times can be reset by Cleanup
+        std::unordered_set<uint256, StaticSaltedHasher> txids;
+    };
+    typedef std::shared_ptr<BlockTxsInfo> BlockTxsInfoPtr;
+
+    // These are not protected by cs but are sharded internally, so that mempool and block notifications don't contend
+    // with each other and with TrySignChainTip
+    sharded_map<uint256, BlockTxsInfoPtr, StaticSaltedHasher> blockTxs;
+    sharded_map<uint256, int64_t, StaticSaltedHasher> txFirstSeenTime;
 
     std::map<uint256, int64_t> seenChainLocks;
 
@@ -97,6 +116,7 @@ public:
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected);
     void CheckActiveState();
     void TrySignChainTip();
+    void ScheduleEnforceBestChainLock();
     void EnforceBestChainLock();
     virtual void HandleNewRecoveredSig(const CRecoveredSig& recoveredSig);
 
@@ -110,9 +130,13 @@ private:
     bool InternalHasChainLock(int nHeight, const uint256& blockHash);
     bool InternalHasConflictingChainLock(int nHeight, const uint256& blockHash);
 
+    std::vector<const CBlockIndex*> FindConflictingBlocks(const CBlockIndex* pindex, const CBlockIndex* pindexTip);
     void DoInvalidateBlock(const CBlockIndex* pindex, bool activateBestChain);
 
-    BlockTxs::mapped_type GetBlockTxs(const uint256& blockHash);
+    BlockTxsInfoPtr CreateBlockTxs(const CBlock& block, int64_t firstSeenTime);
+    BlockTxsInfoPtr GetBlockTxs(const uint256& blockHash);
+    bool IsTxSafe(const uint256& txid, int64_t curTime, int64_t& retTxAge);
+    bool IsBlockSafe(const CBlockIndex* pindex, const BlockTxsInfoPtr& txs);
 
     void Cleanup();
 };
@@ -16,6 +16,7 @@
 
 #include "dbwrapper.h"
 #include "scheduler.h"
+#include "util.h"
 
 namespace llmq
 {
@@ -26,7 +27,11 @@ CDBWrapper* llmqDb;
 
 void InitLLMQSystem(CEvoDB& evoDb, CScheduler* scheduler, bool unitTests, bool fWipe)
 {
-    llmqDb = new CDBWrapper(unitTests ? "" : (GetDataDir() / "llmq"), 1 << 20, unitTests, fWipe);
+    CDBTuningOptions tuning;
+    tuning.nBloomBits = DEFAULT_LLMQ_DB_BLOOM_BITS;
+    tuning.ApplyArgs("llmqdb");
+    int64_t nCacheSize = std::max(gArgs.GetArg("-llmqdbcache", DEFAULT_LLMQ_DB_CACHE), (int64_t)1) << 20;
+    llmqDb = new CDBWrapper(unitTests ? "" : (GetDataDir() / "llmq"), nCacheSize, unitTests, fWipe, false, tuning);
     blsWorker = new CBLSWorker();
 
     quorumDKGDebugManager = new CDKGDebugManager();
@@ -100,6 +105,9 @@ void StopLLMQSystem()
     if (quorumDKGSessionManager) {
         quorumDKGSessionManager->StopMessageHandlerPool();
     }
+    if (quorumManager) {
+        quorumManager->Stop();
+    }
     if (blsWorker) {
         blsWorker->Stop();
     }
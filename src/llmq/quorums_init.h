@@ -5,6 +5,8 @@
 #ifndef DASH_QUORUMS_INIT_H
 #define DASH_QUORUMS_INIT_H
 
+#include <stdint.h>
+
 class CDBWrapper;
 class CEvoDB;
 class CScheduler;
@@ -15,6 +17,12 @@ namespace llmq
 // If true, we will connect to all new quorums and watch their communication
 static const bool DEFAULT_WATCH_QUORUMS = false;
 
+// -llmqdbcache default (MiB)
+static const int64_t DEFAULT_LLMQ_DB_CACHE = 8;
+// The llmq database is dominated by point lookups of keys which usually don't exist (recovered sigs by id, islocks by
+// input), so a more precise bloom filter than the default saves many disk reads
+static const int DEFAULT_LLMQ_DB_BLOOM_BITS = 16;
+
 // Init/destroy LLMQ globals
 void InitLLMQSystem(CEvoDB& evoDb, CScheduler* scheduler, bool unitTests, bool fWipe = false);
 void DestroyLLMQSystem();
@@ -40,6 +40,71 @@ uint256 CInstantSendLock::GetRequestId() const
 
 ////////////////
 
+CInstantSendDb::CInstantSendDb(CDBWrapper& _db) :
+    db(_db)
+{
+    LoadInstantSendLocks();
+}
+
+void CInstantSendDb::LoadInstantSendLocks()
+{
+    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
+    auto firstKey = std::make_tuple(std::string("is_i"), uint256());
+
+    it->Seek(firstKey);
+
+    while (it->Valid()) {
+        decltype(firstKey) curKey;
+        if (!it->GetKey(curKey) || std::get<0>(curKey) != "is_i") {
+            break;
+        }
+
+        auto islock = std::make_shared<CInstantSendLock>();
+        if (!it->GetValue(*islock)) {
+            break;
+        }
+        AddToIndex(std::get<1>(curKey), islock);
+
+        it->Next();
+    }
+
+    LogPrintf("CInstantSendDb::%s -- loaded %d islocks\n", __func__, islocks.size());
+}
+
+void CInstantSendDb::AddToIndex(const uint256& hash, const CInstantSendLockPtr& islock)
+{
+    // assignment instead of emplace, as the DB entries of the txid and inputs are overwritten as well
+    islocks.emplace(hash, islock);
+    islocksByTxid[islock->txid] = hash;
+    for (auto& in : islock->inputs) {
+        islocksByInput[in] = hash;
+        islocksByParent[in.hash].emplace(hash);
+    }
+}
+
+void CInstantSendDb::RemoveFromIndex(const uint256& hash, const CInstantSendLock& islock)
+{
+    islocks.erase(hash);
+    // the txid and inputs might be indexed for another islock by now, which must stay
+    auto itTxid = islocksByTxid.find(islock.txid);
+    if (itTxid != islocksByTxid.end() && itTxid->second == hash) {
+        islocksByTxid.erase(itTxid);
+    }
+    for (auto& in : islock.inputs) {
+        auto itInput = islocksByInput.find(in);
+        if (itInput != islocksByInput.end() && itInput->second == hash) {
+            islocksByInput.erase(itInput);
+        }
+        auto it = islocksByParent.find(in.hash);
+        if (it != islocksByParent.end()) {
+            it->second.erase(hash);
+            if (it->second.empty()) {
+                islocksByParent.erase(it);
+            }
+        }
+    }
+}
+
 void CInstantSendDb::WriteNewInstantSendLock(const uint256& hash, const CInstantSendLock& islock)
 {
     CDBBatch batch(db);
@@ -50,12 +115,7 @@ void CInstantSendDb::WriteNewInstantSendLock(const uint256& hash, const CInstant
     }
     db.WriteBatch(batch);
 
-    auto p = std::make_shared<CInstantSendLock>(islock);
-    islockCache.insert(hash, p);
-    txidCache.insert(islock.txid, hash);
-    for (auto& in : islock.inputs) {
-        outpointCache.insert(in, hash);
-    }
+    AddToIndex(hash, std::make_shared<CInstantSendLock>(islock));
 }
 
 void CInstantSendDb::RemoveInstantSendLock(CDBBatch& batch, const uint256& hash, CInstantSendLockPtr islock)
@@ -73,11 +133,7 @@ void CInstantSendDb::RemoveInstantSendLock(CDBBatch& batch, const uint256& hash,
         batch.Erase(std::make_tuple(std::string("is_in"), in));
     }
 
-    islockCache.erase(hash);
-    txidCache.erase(islock->txid);
-    for (auto& in : islock->inputs) {
-        outpointCache.erase(in);
-    }
+    RemoveFromIndex(hash, *islock);
 }
 
 static std::tuple<std::string, uint32_t, uint256> BuildInversedISLockKey(const std::string& k, int nHeight, const uint256& islockHash)
@@ -177,60 +233,25 @@ bool CInstantSendDb::HasArchivedInstantSendLock(const uint256& islockHash)
 
 size_t CInstantSendDb::GetInstantSendLockCount()
 {
-    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
-    auto firstKey = std::make_tuple(std::string("is_i"), uint256());
-
-    it->Seek(firstKey);
-
-    size_t cnt = 0;
-    while (it->Valid()) {
-        decltype(firstKey) curKey;
-        if (!it->GetKey(curKey) || std::get<0>(curKey) != "is_i") {
-            break;
-        }
-
-        cnt++;
-
-        it->Next();
-    }
-
-    return cnt;
+    return islocks.size();
 }
 
 CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByHash(const uint256& hash)
 {
-    CInstantSendLockPtr ret;
-    if (islockCache.get(hash, ret)) {
-        return ret;
-    }
-
-    ret = std::make_shared<CInstantSendLock>();
-    bool exists = db.Read(std::make_tuple(std::string("is_i"), hash), *ret);
-    if (!exists) {
-        ret = nullptr;
+    auto it = islocks.find(hash);
+    if (it == islocks.end()) {
+        return nullptr;
     }
-    islockCache.insert(hash, ret);
-    return ret;
+    return it->second;
 }
 
 uint256 CInstantSendDb::GetInstantSendLockHashByTxid(const uint256& txid)
 {
-    uint256 islockHash;
-
-    bool found = txidCache.get(txid, islockHash);
-    if (found && islockHash.IsNull()) {
-        return uint256();
-    }
-
-    if (!found) {
-        found = db.Read(std::make_tuple(std::string("is_tx"), txid), islockHash);
-        txidCache.insert(txid, islockHash);
-    }
-
-    if (!found) {
+    auto it = islocksByTxid.find(txid);
+    if (it == islocksByTxid.end()) {
         return uint256();
     }
-    return islockHash;
+    return it->second;
 }
 
 CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByTxid(const uint256& txid)
@@ -244,50 +265,20 @@ CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByTxid(const uint256& txid
 
 CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByInput(const COutPoint& outpoint)
 {
-    uint256 islockHash;
-    bool found = outpointCache.get(outpoint, islockHash);
-    if (found && islockHash.IsNull()) {
-        return nullptr;
-    }
-
-    if (!found) {
-        found = db.Read(std::make_tuple(std::string("is_in"), outpoint), islockHash);
-        outpointCache.insert(outpoint, islockHash);
-    }
-
-    if (!found) {
+    auto it = islocksByInput.find(outpoint);
+    if (it == islocksByInput.end()) {
         return nullptr;
     }
-    return GetInstantSendLockByHash(islockHash);
+    return GetInstantSendLockByHash(it->second);
 }
 
 std::vector<uint256> CInstantSendDb::GetInstantSendLocksByParent(const uint256& parent)
 {
-    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
-    auto firstKey = std::make_tuple(std::string("is_in"), COutPoint(parent, 0));
-    it->Seek(firstKey);
-
-    std::vector<uint256> result;
-
-    while (it->Valid()) {
-        decltype(firstKey) curKey;
-        if (!it->GetKey(curKey) || std::get<0>(curKey) != "is_in") {
-            break;
-        }
-        auto& outpoint = std::get<1>(curKey);
-        if (outpoint.hash != parent) {
-            break;
-        }
-
-        uint256 islockHash;
-        if (!it->GetValue(islockHash)) {
-            break;
-        }
-        result.emplace_back(islockHash);
-        it->Next();
+    auto it = islocksByParent.find(parent);
+    if (it == islocksByParent.end()) {
+        return {};
     }
-
-    return result;
+    return std::vector<uint256>(it->second.begin(), it->second.end());
 }
 
 std::vector<uint256> CInstantSendDb::RemoveChainedInstantSendLocks(const uint256& islockHash, const uint256& txid, int nHeight)
@@ -926,6 +917,8 @@ void CInstantSendManager::ProcessInstantSendLock(NodeId from, const uint256& has
         db.WriteNewInstantSendLock(hash, islock);
         if (pindexMined) {
             db.WriteInstantSendLockMined(hash, pindexMined->nHeight);
+        } else if (tx) {
+            AddRecentLockedTx(tx);
         }
 
         // This will also add children TXs to pendingRetryTxs
@@ -945,6 +938,8 @@ void CInstantSendManager::ProcessInstantSendLock(NodeId from, const uint256& has
         g_connman->RelayInvFiltered(inv, islock.txid, LLMQS_PROTO_VERSION);
     }
 
+    GetMainSignals().NotifyInstantSendLock(islock);
+
     RemoveMempoolConflictsForLock(hash, islock);
     ResolveBlockConflicts(hash, islock);
     UpdateWalletTransaction(tx, islock);
@@ -981,6 +976,12 @@ void CInstantSendManager::ProcessNewTransaction(const CTransactionRef& tx, const
         if (!islockHash.IsNull() && pindex) {
             db.WriteInstantSendLockMined(islockHash, pindex->nHeight);
         }
+
+        if (pindex) {
+            recentLockedTxs.erase(tx->GetHash());
+        } else if (!islockHash.IsNull()) {
+            AddRecentLockedTx(tx);
+        }
     }
 
     if (!masternodeSync.IsBlockchainSynced()) {
@@ -1036,6 +1037,35 @@ void CInstantSendManager::BlockDisconnected(const std::shared_ptr<const CBlock>&
     }
 }
 
+void CInstantSendManager::AddRecentLockedTx(const CTransactionRef& tx)
+{
+    AssertLockHeld(cs);
+
+    static const size_t MAX_RECENT_LOCKED_TXS = 2000;
+
+    if (!recentLockedTxs.emplace(tx->GetHash(), tx).second) {
+        return;
+    }
+    recentLockedTxsOrder.emplace_back(tx->GetHash());
+
+    // Mined TXs are only erased from the map, their stale entries in the order queue are dropped here as well
+    while (recentLockedTxsOrder.size() > MAX_RECENT_LOCKED_TXS) {
+        recentLockedTxs.erase(recentLockedTxsOrder.front());
+        recentLockedTxsOrder.pop_front();
+    }
+}
+
+std::vector<std::pair<uint256, CTransactionRef>> CInstantSendManager::GetRecentLockedTxs()
+{
+    LOCK(cs);
+    std::vector<std::pair<uint256, CTransactionRef>> ret;
+    ret.reserve(recentLockedTxs.size());
+    for (const auto& p : recentLockedTxs) {
+        ret.emplace_back(p.first, p.second);
+    }
+    return ret;
+}
+
 void CInstantSendManager::AddNonLockedTx(const CTransactionRef& tx, const CBlockIndex* pindexMined)
 {
     AssertLockHeld(cs);
@@ -1486,6 +1516,7 @@ CInstantSendLockPtr CInstantSendManager::GetConflictingLock(const CTransaction&
 
 size_t CInstantSendManager::GetInstantSendLockCount()
 {
+    LOCK(cs);
     return db.GetInstantSendLockCount();
 }
 
@@ -8,9 +8,9 @@
 #include "quorums_signing.h"
 
 #include "coins.h"
-#include "unordered_lru_cache.h"
 #include "primitives/transaction.h"
 
+#include <deque>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -45,12 +45,23 @@ class CInstantSendDb
 private:
     CDBWrapper& db;
 
-    unordered_lru_cache<uint256, CInstantSendLockPtr, StaticSaltedHasher, 10000> islockCache;
-    unordered_lru_cache<uint256, uint256, StaticSaltedHasher, 10000> txidCache;
-    unordered_lru_cache<COutPoint, uint256, SaltedOutpointHasher, 10000> outpointCache;
+    /**
+     * Complete in-memory index of all islocks which are not archived yet. It is rebuilt from the database on startup
+     * and kept in sync with every write/erase, so lookups never need to hit the database. Archived islocks are only
+     * kept in the database.
+     */
+    std::unordered_map<uint256, CInstantSendLockPtr, StaticSaltedHasher> islocks;
+    std::unordered_map<uint256, uint256, StaticSaltedHasher> islocksByTxid;
+    std::unordered_map<COutPoint, uint256, SaltedOutpointHasher> islocksByInput;
+    // maps from parent txid to the islocks which spend outputs of the parent
+    std::unordered_map<uint256, std::unordered_set<uint256, StaticSaltedHasher>, StaticSaltedHasher> islocksByParent;
+
+    void LoadInstantSendLocks();
+    void AddToIndex(const uint256& hash, const CInstantSendLockPtr& islock);
+    void RemoveFromIndex(const uint256& hash, const CInstantSendLock& islock);
 
 public:
-    CInstantSendDb(CDBWrapper& _db) : db(_db) {}
+    CInstantSendDb(CDBWrapper& _db);
 
     void WriteNewInstantSendLock(const uint256& hash, const CInstantSendLock& islock);
     void RemoveInstantSendLock(CDBBatch& batch, const uint256& hash, CInstantSendLockPtr islock);
@@ -111,6 +122,11 @@ private:
 
     std::unordered_set<uint256, StaticSaltedHasher> pendingRetryTxs;
 
+    // Recently locked TXs which are not mined yet. These are kept for compact block reconstruction even if they get
+    // evicted from the mempool in the meantime
+    std::unordered_map<uint256, CTransactionRef, StaticSaltedHasher> recentLockedTxs;
+    std::deque<uint256> recentLockedTxsOrder;
+
 public:
     CInstantSendManager(CDBWrapper& _llmqDb);
     ~CInstantSendManager();
@@ -146,6 +162,9 @@ public:
     void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted);
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected);
 
+    void AddRecentLockedTx(const CTransactionRef& tx);
+    std::vector<std::pair<uint256, CTransactionRef>> GetRecentLockedTxs();
+
     void AddNonLockedTx(const CTransactionRef& tx, const CBlockIndex* pindexMined);
     void RemoveNonLockedTx(const uint256& txid, bool retryChildren);
     void RemoveConflictedTx(const CTransaction& tx);
@@ -14,6 +14,7 @@
 #include "netmessagemaker.h"
 #include "scheduler.h"
 #include "validation.h"
+#include "validationinterface.h"
 
 #include <algorithm>
 #include <limits>
@@ -721,6 +722,8 @@ void CSigningManager::ProcessRecoveredSig(NodeId nodeId, const CRecoveredSig& re
     for (auto& l : listeners) {
         l->HandleNewRecoveredSig(recoveredSig);
     }
+
+    GetMainSignals().NotifyRecoveredSig(recoveredSig);
 }
 
 void CSigningManager::PushReconstructedRecoveredSig(const llmq::CRecoveredSig& recoveredSig, const llmq::CQuorumCPtr& quorum)
@@ -297,7 +297,10 @@ void CMasternodeSync::SendGovernanceSyncRequest(CNode* pnode, CConnman& connman)
 {
     CNetMsgMaker msgMaker(pnode->GetSendVersion());
 
-    if(pnode->nVersion >= GOVERNANCE_FILTER_PROTO_VERSION) {
+    if(pnode->nVersion >= GOVERNANCE_RECONCILIATION_PROTO_VERSION) {
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::MNGOVERNANCERECON, uint256(), governance.GetObjectsReconSketch()));
+    }
+    else if(pnode->nVersion >= GOVERNANCE_FILTER_PROTO_VERSION) {
         CBloomFilter filter;
         filter.clear();
 
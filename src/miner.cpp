@@ -56,6 +56,54 @@
 uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockSize = 0;
 
+// Mempool transactions picked for the last template. As long as the tip and the options do not change and the
+// selection did not hit the block limits, every one of them would be picked again, so the next template can start
+// with them and only needs to consider the packages which were not selected yet.
+struct CCachedPackageSelection {
+    uint256 hashPrevBlock;
+    unsigned int nBlockMaxSize{0};
+    CFeeRate blockMinFeeRate;
+    bool fLimitReached{true};
+    // txid and modified fee at the time of selection, in block order
+    std::vector<std::pair<uint256, CAmount>> vTxs;
+};
+static CCachedPackageSelection cachedPackageSelection; // protected by cs_main
+
+// CbTx merkle roots of the last template. They only depend on the previous block, the special transactions in the
+// block and the masternode collaterals spent by it, so they are reused while these stay the same.
+struct CCachedCbTxRoots {
+    uint256 key;
+    uint256 merkleRootMNList;
+    uint256 merkleRootQuorums;
+};
+static CCachedCbTxRoots cachedCbTxRoots; // protected by cs_main
+
+static bool GetCbTxRootsCacheKey(const CBlock& block, const CBlockIndex* pindexPrev, uint256& keyRet)
+{
+    auto mnList = deterministicMNManager->GetListForBlock(pindexPrev);
+
+    CHashWriter hw(SER_GETHASH, 0);
+    hw << pindexPrev->GetBlockHash();
+    // we skip the coinbase
+    for (size_t i = 1; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        if (tx.nVersion == 3 && tx.nType != TRANSACTION_NORMAL) {
+            if (tx.nType == TRANSACTION_PROVIDER_REGISTER) {
+                // new collaterals might be spent by other transactions in the same block, don't try to cache this
+                return false;
+            }
+            hw << tx.GetHash();
+        }
+        for (const auto& in : tx.vin) {
+            if (mnList.HasMNByCollateral(in.prevout)) {
+                hw << in.prevout;
+            }
+        }
+    }
+    keyRet = hw.GetHash();
+    return true;
+}
+
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
 {
     int64_t nOldTime = pblock->nTime;
@@ -114,6 +162,8 @@ void BlockAssembler::resetBlock()
     // These counters do not include coinbase tx
     nBlockTx = 0;
     nFees = 0;
+
+    fLimitReached = false;
 }
 
 std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn)
@@ -167,10 +217,33 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
         }
     }
 
+    // Remember the state before any mempool txs are added, in case the reused selection has to be dropped
+    const size_t nFirstPackageTx = pblock->vtx.size();
+    const uint64_t nBaseBlockSize = nBlockSize;
+    const uint64_t nBaseBlockTx = nBlockTx;
+
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
+    nCachedTxs = addCachedPackageTxs();
     addPackageTxs(nPackagesSelected, nDescendantsUpdated);
 
+    if (nCachedTxs != 0 && fLimitReached) {
+        // New packages had to compete with the reused ones for space, so the result might differ from a selection
+        // done from scratch. Redo it to not end up with a worse block.
+        pblock->vtx.resize(nFirstPackageTx);
+        pblocktemplate->vTxFees.resize(nFirstPackageTx);
+        pblocktemplate->vTxSigOps.resize(nFirstPackageTx);
+        resetBlock();
+        nBlockSize = nBaseBlockSize;
+        nBlockTx = nBaseBlockTx;
+
+        nCachedTxs = 0;
+        nPackagesSelected = 0;
+        nDescendantsUpdated = 0;
+        addPackageTxs(nPackagesSelected, nDescendantsUpdated);
+    }
+    UpdatePackageCache(pindexPrev, nFirstPackageTx);
+
     int64_t nTime1 = GetTimeMicros();
 
     nLastBlockTx = nBlockTx;
@@ -190,6 +263,8 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     // Compute regular coinbase transaction.
     coinbaseTx.vout[0].nValue = blockReward;
 
+    fCbTxRootsCached = false;
+
     if (!fDIP0003Active_context) {
         coinbaseTx.vin[0].scriptSig = CScript() << nHeight << OP_0;
     } else {
@@ -208,13 +283,26 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
         cbTx.nHeight = nHeight;
 
-        CValidationState state;
-        if (!CalcCbTxMerkleRootMNList(*pblock, pindexPrev, cbTx.merkleRootMNList, state)) {
-            throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootMNList failed: %s", __func__, FormatStateMessage(state)));
-        }
-        if (fDIP0008Active_context) {
-            if (!CalcCbTxMerkleRootQuorums(*pblock, pindexPrev, cbTx.merkleRootQuorums, state)) {
-                throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootQuorums failed: %s", __func__, FormatStateMessage(state)));
+        uint256 cacheKey;
+        bool fCacheable = GetCbTxRootsCacheKey(*pblock, pindexPrev, cacheKey);
+        if (fCacheable && cacheKey == cachedCbTxRoots.key) {
+            cbTx.merkleRootMNList = cachedCbTxRoots.merkleRootMNList;
+            cbTx.merkleRootQuorums = cachedCbTxRoots.merkleRootQuorums;
+            fCbTxRootsCached = true;
+        } else {
+            CValidationState state;
+            if (!CalcCbTxMerkleRootMNList(*pblock, pindexPrev, cbTx.merkleRootMNList, state)) {
+                throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootMNList failed: %s", __func__, FormatStateMessage(state)));
+            }
+            if (fDIP0008Active_context) {
+                if (!CalcCbTxMerkleRootQuorums(*pblock, pindexPrev, cbTx.merkleRootQuorums, state)) {
+                    throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootQuorums failed: %s", __func__, FormatStateMessage(state)));
+                }
+            }
+            if (fCacheable) {
+                cachedCbTxRoots.key = cacheKey;
+                cachedCbTxRoots.merkleRootMNList = cbTx.merkleRootMNList;
+                cachedCbTxRoots.merkleRootQuorums = cbTx.merkleRootQuorums;
             }
         }
 
@@ -242,7 +330,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     }
     int64_t nTime2 = GetTimeMicros();
 
-    LogPrint(BCLog::BENCHMARK, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+    LogPrint(BCLog::BENCHMARK, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants, %d reused txs), cbtx roots cached: %d, validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, nCachedTxs, fCbTxRootsCached, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
 
     return std::move(pblocktemplate);
 }
@@ -441,6 +529,7 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
         }
 
         if (!TestPackage(packageSize, packageSigOps)) {
+            fLimitReached = true;
             if (fUsingModified) {
                 // Since we always look at the best entry in mapModifiedTx,
                 // we must erase failed entries so that we can consider the
@@ -495,6 +584,54 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     }
 }
 
+int BlockAssembler::addCachedPackageTxs()
+{
+    const CCachedPackageSelection& cache = cachedPackageSelection;
+    if (cache.fLimitReached || cache.vTxs.empty() ||
+            cache.hashPrevBlock != chainActive.Tip()->GetBlockHash() ||
+            cache.nBlockMaxSize != nBlockMaxSize || cache.blockMinFeeRate != blockMinFeeRate) {
+        return 0;
+    }
+
+    // All txs must still be in the mempool with the same fee, otherwise the selection might be different now
+    std::vector<CTxMemPool::txiter> vEntries;
+    vEntries.reserve(cache.vTxs.size());
+    for (const auto& p : cache.vTxs) {
+        auto it = mempool.mapTx.find(p.first);
+        if (it == mempool.mapTx.end() || it->GetModifiedFee() != p.second) {
+            return 0;
+        }
+        vEntries.emplace_back(it);
+    }
+
+    // Locktime can't change without a new tip, but the ChainLocks related checks might
+    if (!TestPackageTransactions(CTxMemPool::setEntries(vEntries.begin(), vEntries.end()))) {
+        return 0;
+    }
+
+    // The cached order was valid for the previous template and none of the ancestors changed since then
+    for (const auto& it : vEntries) {
+        AddToBlock(it);
+    }
+    return (int)vEntries.size();
+}
+
+void BlockAssembler::UpdatePackageCache(const CBlockIndex* pindexPrev, size_t nFirstPackageTx)
+{
+    CCachedPackageSelection& cache = cachedPackageSelection;
+    cache.hashPrevBlock = pindexPrev->GetBlockHash();
+    cache.nBlockMaxSize = nBlockMaxSize;
+    cache.blockMinFeeRate = blockMinFeeRate;
+    cache.fLimitReached = fLimitReached;
+    cache.vTxs.clear();
+    cache.vTxs.reserve(pblock->vtx.size() - nFirstPackageTx);
+    for (size_t i = nFirstPackageTx; i < pblock->vtx.size(); i++) {
+        auto it = mempool.mapTx.find(pblock->vtx[i]->GetHash());
+        assert(it != mempool.mapTx.end());
+        cache.vTxs.emplace_back(it->GetTx().GetHash(), it->GetModifiedFee());
+    }
+}
+
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
 {
     // Update nExtraNonce
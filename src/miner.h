@@ -150,12 +150,18 @@ private:
     unsigned int nBlockSigOps;
     CAmount nFees;
     CTxMemPool::setEntries inBlock;
+    // Set when a package was rejected because the block ran out of size or sigops
+    bool fLimitReached;
 
     // Chain context for the block
     int nHeight;
     int64_t nLockTimeCutoff;
     const CChainParams& chainparams;
 
+    // Reuse statistics of the last CreateNewBlock call
+    int nCachedTxs{0};
+    bool fCbTxRootsCached{false};
+
 public:
     struct Options {
         Options();
@@ -169,6 +175,11 @@ public:
     /** Construct a new block template with coinbase to scriptPubKeyIn */
     std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn);
 
+    /** Number of transactions the last template reused from the previous package selection */
+    int GetCachedTxCount() const { return nCachedTxs; }
+    /** Whether the last template reused the CbTx merkle roots of the previous one */
+    bool AreCbTxRootsCached() const { return fCbTxRootsCached; }
+
 private:
     // utility functions
     /** Clear the block's state and prepare for assembling a new block */
@@ -181,6 +192,11 @@ private:
       * Increments nPackagesSelected / nDescendantsUpdated with corresponding
       * statistics from the package selection (for logging statistics). */
     void addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated);
+    /** Add the transactions selected for the previous template on the same tip, if they are all still
+      * in the mempool unchanged. Returns the number of added transactions. */
+    int addCachedPackageTxs();
+    /** Remember the selected transactions so that the next template can start from them */
+    void UpdatePackageCache(const CBlockIndex* pindexPrev, size_t nFirstPackageTx);
 
     // helper functions for addPackageTxs()
     /** Remove confirmed (inBlock) entries from given set */
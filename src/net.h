@@ -73,6 +73,10 @@ static const unsigned int MAX_INV_SZ = 50000;
 static const unsigned int MAX_ADDR_TO_SEND = 1000;
 /** Maximum length of incoming protocol messages (no message over 3 MiB is currently acceptable). */
 static const unsigned int MAX_PROTOCOL_MESSAGE_LENGTH = 3 * 1024 * 1024;
+/** Maximum number of processed messages per peer kept around to reuse their receive buffers */
+static const size_t MAX_RECYCLED_MSGS = 4;
+/** Only buffers of small messages are recycled, larger ones are freed right away */
+static const unsigned int MAX_RECYCLED_MSG_SIZE = 4 * 1024;
 /** Maximum length of strSubVer in `version` message */
 static const unsigned int MAX_SUBVERSION_LENGTH = 256;
 /** Maximum number of automatic outgoing nodes */
@@ -127,6 +131,23 @@ struct AddedNodeInfo
 class CNodeStats;
 class CClientUIInterface;
 
+/**
+ * An immutable, serialized message payload which can be queued for multiple peers without copying it. The double-SHA256
+ * of the payload is computed once, as it is needed for the checksum in every message header.
+ */
+struct CSharedNetMsgPayload
+{
+    explicit CSharedNetMsgPayload(std::vector<unsigned char>&& _data) :
+        data(std::move(_data)),
+        hash(Hash(data.begin(), data.end()))
+    {
+    }
+
+    const std::vector<unsigned char> data;
+    const uint256 hash;
+};
+typedef std::shared_ptr<const CSharedNetMsgPayload> CSharedNetMsgPayloadPtr;
+
 struct CSerializedNetMsg
 {
     CSerializedNetMsg() = default;
@@ -137,9 +158,25 @@ struct CSerializedNetMsg
     CSerializedNetMsg& operator=(const CSerializedNetMsg&) = delete;
 
     std::vector<unsigned char> data;
+    // if set, this is sent instead of data
+    CSharedNetMsgPayloadPtr sharedPayload;
     std::string command;
 };
 
+/** A single entry of CNode::vSendMsg, either owning its bytes or referencing a shared payload */
+struct CSendBuffer
+{
+    explicit CSendBuffer(std::vector<unsigned char>&& _data) : data(std::move(_data)) {}
+    explicit CSendBuffer(CSharedNetMsgPayloadPtr _sharedPayload) : sharedPayload(std::move(_sharedPayload)) {}
+
+    const unsigned char* begin() const { return sharedPayload ? sharedPayload->data.data() : data.data(); }
+    size_t size() const { return sharedPayload ? sharedPayload->data.size() : data.size(); }
+
+private:
+    std::vector<unsigned char> data;
+    CSharedNetMsgPayloadPtr sharedPayload;
+};
+
 class NetEventsInterface;
 class CConnman
 {
@@ -743,9 +780,43 @@ public:
 
     int readHeader(const char *pch, unsigned int nBytes);
     int readData(const char *pch, unsigned int nBytes);
+
+    /** Prepare a processed message for receiving a new one, keeping the allocated buffers */
+    void Reset(const CMessageHeader::MessageStartChars& pchMessageStartIn, int nVersionIn);
 };
 
 
+/**
+ * Orphan transactions of a peer which might be resolvable now. IS-locked orphans (or orphans of IS-locked parents)
+ * are kept in their own set, so that they can be picked first without scanning the whole work set.
+ */
+struct COrphanWorkSet
+{
+    std::set<uint256> locked;
+    std::set<uint256> other;
+
+    bool empty() const { return locked.empty() && other.empty(); }
+    size_t size() const { return locked.size() + other.size(); }
+
+    void insert(const uint256& hash, bool fLocked)
+    {
+        if (fLocked) {
+            other.erase(hash);
+            locked.insert(hash);
+        } else if (!locked.count(hash)) {
+            other.insert(hash);
+        }
+    }
+
+    uint256 pop()
+    {
+        auto& s = !locked.empty() ? locked : other;
+        uint256 hash = *s.begin();
+        s.erase(s.begin());
+        return hash;
+    }
+};
+
 /** Information about a peer */
 class CNode
 {
@@ -757,7 +828,7 @@ public:
     size_t nSendSize; // total size of all vSendMsg entries
     size_t nSendOffset; // offset inside the first vSendMsg already sent
     uint64_t nSendBytes;
-    std::deque<std::vector<unsigned char>> vSendMsg;
+    std::deque<CSendBuffer> vSendMsg;
     CCriticalSection cs_vSend;
     CCriticalSection cs_hSocket;
     CCriticalSection cs_vRecv;
@@ -766,6 +837,11 @@ public:
     std::list<CNetMessage> vProcessMsg;
     size_t nProcessQueueSize;
 
+    // Processed messages handed back by RecycleMsgs, reused by ReceiveMsgBytes. No other lock may be taken while
+    // holding cs_vRecycledMsgs
+    CCriticalSection cs_vRecycledMsgs;
+    std::list<CNetMessage> vRecycledMsgs;
+
     CCriticalSection cs_sendProcessing;
 
     std::deque<CInv> vRecvGetData;
@@ -889,7 +965,7 @@ public:
     // If true, we will send him all quorum related messages, even if he is not a member of our quorums
     std::atomic<bool> qwatch{false};
 
-    std::set<uint256> orphan_work_set;
+    COrphanWorkSet orphan_work_set;
 
     CNode(NodeId id, ServiceFlags nLocalServicesIn, int nMyStartingHeightIn, SOCKET hSocketIn, const CAddress &addrIn, uint64_t nKeyedNetGroupIn, uint64_t nLocalHostNonceIn, const CAddress &addrBindIn, const std::string &addrNameIn = "", bool fInboundIn = false);
     ~CNode();
@@ -934,6 +1010,8 @@ public:
     }
 
     bool ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete);
+    /** Hand processed messages back so that their buffers can be reused for receiving */
+    void RecycleMsgs(std::list<CNetMessage>& msgs);
 
     void SetRecvVersion(int nVersionIn)
     {
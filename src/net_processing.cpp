@@ -55,37 +55,43 @@
 #include "llmq/quorums_signing.h"
 #include "llmq/quorums_signing_shares.h"
 
+#include <list>
+#include <unordered_map>
+
 #if defined(NDEBUG)
 # error "Dash Core cannot be compiled without assertions."
 #endif
 
 std::atomic<int64_t> nTimeBestReceived(0); // Used only to inform the wallet of when we last received a block
 
-struct IteratorComparator
-{
-    template<typename I>
-    bool operator()(const I& a, const I& b)
-    {
-        return &(*a) < &(*b);
-    }
-};
-
 struct COrphanTx {
     // When modifying, adapt the copy of this definition in tests/DoS_tests.
     CTransactionRef tx;
     NodeId fromPeer;
     int64_t nTimeExpire;
     size_t nTxSize;
+    // position in vOrphanList
+    size_t nListPos;
+    // the orphan or one of its parents is IS-locked, such orphans are resolved first
+    bool fISLocked;
 };
 static CCriticalSection g_cs_orphans;
-std::map<uint256, COrphanTx> mapOrphanTransactions GUARDED_BY(g_cs_orphans);
-std::map<COutPoint, std::set<std::map<uint256, COrphanTx>::iterator, IteratorComparator>> mapOrphanTransactionsByPrev GUARDED_BY(g_cs_orphans);
+std::unordered_map<uint256, COrphanTx, StaticSaltedHasher> mapOrphanTransactions GUARDED_BY(g_cs_orphans);
+std::unordered_map<COutPoint, std::set<uint256>, SaltedOutpointHasher> mapOrphanTransactionsByPrev GUARDED_BY(g_cs_orphans);
+std::unordered_map<NodeId, std::set<uint256>> mapOrphanTransactionsByPeer GUARDED_BY(g_cs_orphans);
+// hashes of all orphans, for random eviction in constant time
+std::vector<uint256> vOrphanList GUARDED_BY(g_cs_orphans);
 size_t nMapOrphanTransactionsSize = 0;
 void EraseOrphansFor(NodeId peer);
 
 static size_t vExtraTxnForCompactIt GUARDED_BY(g_cs_orphans) = 0;
 static std::vector<std::pair<uint256, CTransactionRef>> vExtraTxnForCompact GUARDED_BY(g_cs_orphans);
 
+/** Outcome of compact block reconstructions for blocks we were waiting for */
+static uint64_t nCmpctBlocksDirect GUARDED_BY(cs_main) = 0;
+static uint64_t nCmpctBlocksRoundTrip GUARDED_BY(cs_main) = 0;
+static uint64_t nCmpctBlocksFailed GUARDED_BY(cs_main) = 0;
+
 static const uint64_t RANDOMIZER_ID_ADDRESS_RELAY = 0x3cac0035b5866b90ULL; // SHA256("main address relay")[0:8]
 
 /// Age after which a stale block will no longer be served if requested as
@@ -684,11 +690,21 @@ bool AddOrphanTx(const CTransactionRef& tx, NodeId peer) EXCLUSIVE_LOCKS_REQUIRE
         return false;
     }
 
-    auto ret = mapOrphanTransactions.emplace(hash, COrphanTx{tx, peer, GetTime() + ORPHAN_TX_EXPIRE_TIME, sz});
+    bool fISLocked = false;
+    if (llmq::quorumInstantSendManager) {
+        fISLocked = llmq::quorumInstantSendManager->IsLocked(hash);
+        for (size_t i = 0; i < tx->vin.size() && !fISLocked; i++) {
+            fISLocked = llmq::quorumInstantSendManager->IsLocked(tx->vin[i].prevout.hash);
+        }
+    }
+
+    auto ret = mapOrphanTransactions.emplace(hash, COrphanTx{tx, peer, GetTime() + ORPHAN_TX_EXPIRE_TIME, sz, vOrphanList.size(), fISLocked});
     assert(ret.second);
+    vOrphanList.emplace_back(hash);
     for (const CTxIn& txin : tx->vin) {
-        mapOrphanTransactionsByPrev[txin.prevout].insert(ret.first);
+        mapOrphanTransactionsByPrev[txin.prevout].insert(hash);
     }
+    mapOrphanTransactionsByPeer[peer].insert(hash);
 
     AddToCompactExtraTransactions(tx);
 
@@ -701,7 +717,7 @@ bool AddOrphanTx(const CTransactionRef& tx, NodeId peer) EXCLUSIVE_LOCKS_REQUIRE
 
 int static EraseOrphanTx(uint256 hash) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans)
 {
-    std::map<uint256, COrphanTx>::iterator it = mapOrphanTransactions.find(hash);
+    auto it = mapOrphanTransactions.find(hash);
     if (it == mapOrphanTransactions.end())
         return 0;
     for (const CTxIn& txin : it->second.tx->vin)
@@ -709,10 +725,27 @@ int static EraseOrphanTx(uint256 hash) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans)
         auto itPrev = mapOrphanTransactionsByPrev.find(txin.prevout);
         if (itPrev == mapOrphanTransactionsByPrev.end())
             continue;
-        itPrev->second.erase(it);
+        itPrev->second.erase(hash);
         if (itPrev->second.empty())
             mapOrphanTransactionsByPrev.erase(itPrev);
     }
+
+    auto itPeer = mapOrphanTransactionsByPeer.find(it->second.fromPeer);
+    if (itPeer != mapOrphanTransactionsByPeer.end()) {
+        itPeer->second.erase(hash);
+        if (itPeer->second.empty())
+            mapOrphanTransactionsByPeer.erase(itPeer);
+    }
+
+    // move the last entry of vOrphanList into the freed slot
+    size_t nOldPos = it->second.nListPos;
+    assert(vOrphanList[nOldPos] == hash);
+    if (nOldPos != vOrphanList.size() - 1) {
+        vOrphanList[nOldPos] = vOrphanList.back();
+        mapOrphanTransactions.at(vOrphanList[nOldPos]).nListPos = nOldPos;
+    }
+    vOrphanList.pop_back();
+
     assert(nMapOrphanTransactionsSize >= it->second.nTxSize);
     nMapOrphanTransactionsSize -= it->second.nTxSize;
     mapOrphanTransactions.erase(it);
@@ -723,13 +756,13 @@ void EraseOrphansFor(NodeId peer)
 {
     LOCK(g_cs_orphans);
     int nErased = 0;
-    std::map<uint256, COrphanTx>::iterator iter = mapOrphanTransactions.begin();
-    while (iter != mapOrphanTransactions.end())
-    {
-        std::map<uint256, COrphanTx>::iterator maybeErase = iter++; // increment to avoid iterator becoming invalid
-        if (maybeErase->second.fromPeer == peer)
-        {
-            nErased += EraseOrphanTx(maybeErase->second.tx->GetHash());
+    auto itPeer = mapOrphanTransactionsByPeer.find(peer);
+    if (itPeer != mapOrphanTransactionsByPeer.end()) {
+        // EraseOrphanTx modifies the set
+        std::set<uint256> setOrphans = std::move(itPeer->second);
+        mapOrphanTransactionsByPeer.erase(itPeer);
+        for (const uint256& hash : setOrphans) {
+            nErased += EraseOrphanTx(hash);
         }
     }
     if (nErased > 0) LogPrint(BCLog::MEMPOOL, "Erased %d orphan tx from peer=%d\n", nErased, peer);
@@ -747,16 +780,17 @@ unsigned int LimitOrphanTxSize(unsigned int nMaxOrphansSize)
         // Sweep out expired orphan pool entries:
         int nErased = 0;
         int64_t nMinExpTime = nNow + ORPHAN_TX_EXPIRE_TIME - ORPHAN_TX_EXPIRE_INTERVAL;
-        std::map<uint256, COrphanTx>::iterator iter = mapOrphanTransactions.begin();
-        while (iter != mapOrphanTransactions.end())
-        {
-            std::map<uint256, COrphanTx>::iterator maybeErase = iter++;
-            if (maybeErase->second.nTimeExpire <= nNow) {
-                nErased += EraseOrphanTx(maybeErase->second.tx->GetHash());
+        std::vector<uint256> vExpired;
+        for (const auto& p : mapOrphanTransactions) {
+            if (p.second.nTimeExpire <= nNow) {
+                vExpired.emplace_back(p.first);
             } else {
-                nMinExpTime = std::min(maybeErase->second.nTimeExpire, nMinExpTime);
+                nMinExpTime = std::min(p.second.nTimeExpire, nMinExpTime);
             }
         }
+        for (const uint256& hash : vExpired) {
+            nErased += EraseOrphanTx(hash);
+        }
         // Sweep again 5 minutes after the next entry that expires in order to batch the linear scan.
         nNextSweep = nMinExpTime + ORPHAN_TX_EXPIRE_INTERVAL;
         if (nErased > 0) LogPrint(BCLog::MEMPOOL, "Erased %d orphan tx due to expiration\n", nErased);
@@ -764,17 +798,33 @@ unsigned int LimitOrphanTxSize(unsigned int nMaxOrphansSize)
     while (!mapOrphanTransactions.empty() && nMapOrphanTransactionsSize > nMaxOrphansSize)
     {
         // Evict a random orphan:
-        uint256 randomhash = GetRandHash();
-        std::map<uint256, COrphanTx>::iterator it = mapOrphanTransactions.lower_bound(randomhash);
-        if (it == mapOrphanTransactions.end())
-            it = mapOrphanTransactions.begin();
-        EraseOrphanTx(it->first);
+        size_t randompos = GetRand(vOrphanList.size());
+        EraseOrphanTx(vOrphanList[randompos]);
         ++nEvicted;
     }
     return nEvicted;
 }
 
-void static ProcessOrphanTx(CConnman* connman, std::set<uint256>& orphan_work_set) EXCLUSIVE_LOCKS_REQUIRED(cs_main, g_cs_orphans);
+void static ProcessOrphanTx(CConnman* connman, COrphanWorkSet& orphan_work_set) EXCLUSIVE_LOCKS_REQUIRED(cs_main, g_cs_orphans);
+
+/**
+ * Adds the orphans which spend outputs of tx to orphan_work_set. If tx is IS-locked, its orphans are flagged so that
+ * they are resolved before other orphans.
+ */
+void AddOrphanChildrenToWorkSet(const CTransaction& tx, COrphanWorkSet& orphan_work_set, bool fParentLocked) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans)
+{
+    for (unsigned int i = 0; i < tx.vout.size(); i++) {
+        auto it_by_prev = mapOrphanTransactionsByPrev.find(COutPoint(tx.GetHash(), i));
+        if (it_by_prev == mapOrphanTransactionsByPrev.end()) {
+            continue;
+        }
+        for (const uint256& orphanHash : it_by_prev->second) {
+            bool& fISLocked = mapOrphanTransactions.at(orphanHash).fISLocked;
+            fISLocked |= fParentLocked;
+            orphan_work_set.insert(orphanHash, fISLocked);
+        }
+    }
+}
 
 // Requires cs_main.
 void Misbehaving(NodeId pnode, int howmuch)
@@ -848,27 +898,19 @@ void PeerLogicValidation::BlockConnected(const std::shared_ptr<const CBlock>& pb
     LOCK2(cs_main, g_cs_orphans);
 
     std::vector<uint256> vOrphanErase;
-    std::set<uint256> orphanWorkSet;
+    COrphanWorkSet orphanWorkSet;
 
     for (const CTransactionRef& ptx : pblock->vtx) {
         const CTransaction& tx = *ptx;
 
         // Which orphan pool entries we should reprocess and potentially try to accept into mempool again?
-        for (size_t i = 0; i < tx.vin.size(); i++) {
-            auto itByPrev = mapOrphanTransactionsByPrev.find(COutPoint(tx.GetHash(), (uint32_t)i));
-            if (itByPrev == mapOrphanTransactionsByPrev.end()) continue;
-            for (const auto& elem : itByPrev->second) {
-                orphanWorkSet.insert(elem->first);
-            }
-        }
+        AddOrphanChildrenToWorkSet(tx, orphanWorkSet, false);
 
         // Which orphan pool entries must we evict?
         for (const auto& txin : tx.vin) {
             auto itByPrev = mapOrphanTransactionsByPrev.find(txin.prevout);
             if (itByPrev == mapOrphanTransactionsByPrev.end()) continue;
-            for (auto mi = itByPrev->second.begin(); mi != itByPrev->second.end(); ++mi) {
-                const CTransaction& orphanTx = *(*mi)->second.tx;
-                const uint256& orphanHash = orphanTx.GetHash();
+            for (const uint256& orphanHash : itByPrev->second) {
                 vOrphanErase.push_back(orphanHash);
             }
         }
@@ -897,6 +939,41 @@ static std::shared_ptr<const CBlock> most_recent_block;
 static std::shared_ptr<const CBlockHeaderAndShortTxIDs> most_recent_compact_block;
 static uint256 most_recent_block_hash;
 
+// Transactions of the block which were neither announced to the peer nor by the peer, so it most likely doesn't
+// have them. Limited in size, as prefilling too much would cost more than the getblocktxn round trip it saves
+static std::set<uint256> GetPeerUnknownBlockTxs(CNode* pnode, const CBlock& block)
+{
+    std::set<uint256> ret;
+    size_t nTotalSize = 0;
+    LOCK(pnode->cs_inventory);
+    for (size_t i = 1; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        if (CBlockHeaderAndShortTxIDs::IsAlwaysPrefilled(tx) || pnode->filterInventoryKnown.contains(tx.GetHash())) {
+            continue;
+        }
+        // skip txs which don't fit anymore, smaller ones later in the block might still fit
+        size_t nTxSize = tx.GetTotalSize();
+        if (nTotalSize + nTxSize > MAX_CMPCTBLOCK_PEER_PREFILL_SIZE) {
+            continue;
+        }
+        nTotalSize += nTxSize;
+        ret.emplace(tx.GetHash());
+    }
+    return ret;
+}
+
+// Sends the shared compact block if there is nothing to prefill for this peer, otherwise builds one for it
+static void PushCompactBlock(CConnman* connman, CNode* pnode, const CNetMsgMaker& msgMaker, const CBlock& block, const CBlockHeaderAndShortTxIDs* pcmpctblock)
+{
+    std::set<uint256> unknownTxs = GetPeerUnknownBlockTxs(pnode, block);
+    if (pcmpctblock && unknownTxs.empty()) {
+        connman->PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock));
+    } else {
+        CBlockHeaderAndShortTxIDs cmpctblock(block, unknownTxs);
+        connman->PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, cmpctblock));
+    }
+}
+
 void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock) {
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs> (*pblock);
     const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
@@ -917,7 +994,7 @@ void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std:
         most_recent_compact_block = pcmpctblock;
     }
 
-    connman->ForEachNode([this, &pcmpctblock, pindex, &msgMaker, &hashBlock](CNode* pnode) {
+    connman->ForEachNode([this, &pcmpctblock, pindex, &msgMaker, &hashBlock, &pblock](CNode* pnode) {
         // TODO: Avoid the repeated-serialization here
         if (pnode->fDisconnect)
             return;
@@ -930,7 +1007,7 @@ void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std:
 
             LogPrint(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", "PeerLogicValidation::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->GetId());
-            connman->PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock));
+            PushCompactBlock(connman, pnode, msgMaker, *pblock, pcmpctblock.get());
             state.pindexBestHeaderSent = pindex;
         }
     });
@@ -1232,10 +1309,9 @@ void static ProcessGetBlockData(CNode* pfrom, const Consensus::Params& consensus
             // instead we respond with the full, non-compact block.
             if (CanDirectFetch(consensusParams) && mi->second->nHeight >= chainActive.Height() - MAX_CMPCTBLOCK_DEPTH) {
                 if (a_recent_compact_block && a_recent_compact_block->header.GetHash() == mi->second->GetBlockHash()) {
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::CMPCTBLOCK, *a_recent_compact_block));
+                    PushCompactBlock(connman, pfrom, msgMaker, *pblock, a_recent_compact_block.get());
                 } else {
-                    CBlockHeaderAndShortTxIDs cmpctblock(*pblock);
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::CMPCTBLOCK, cmpctblock));
+                    PushCompactBlock(connman, pfrom, msgMaker, *pblock, nullptr);
                 }
             } else {
                 connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, *pblock));
@@ -1256,6 +1332,97 @@ void static ProcessGetBlockData(CNode* pfrom, const Consensus::Params& consensus
     }
 }
 
+namespace {
+/**
+ * Serialized payloads of governance objects and votes served via getdata, keyed by (inv type, hash). The network
+ * serialization of these never changes, so it is done once and the same refcounted buffer (including its checksum) is
+ * queued for every peer which asks for it. Bounded by the total payload size, the least recently used entries are
+ * evicted first. Callers must still check that the object is known before serving a cached payload.
+ */
+class CInvPayloadCache
+{
+private:
+    typedef std::pair<int, uint256> Key;
+    typedef std::list<std::pair<Key, CSharedNetMsgPayloadPtr>> ListType;
+
+    CCriticalSection cs;
+    // most recently used first
+    ListType lruList;
+    std::unordered_map<Key, ListType::iterator, StaticSaltedHasher> index;
+    size_t nTotalSize{0};
+    const size_t nMaxSize;
+
+public:
+    explicit CInvPayloadCache(size_t _nMaxSize) : nMaxSize(_nMaxSize) {}
+
+    CSharedNetMsgPayloadPtr Get(const CInv& inv)
+    {
+        LOCK(cs);
+        auto it = index.find(Key(inv.type, inv.hash));
+        if (it == index.end()) {
+            return nullptr;
+        }
+        lruList.splice(lruList.begin(), lruList, it->second);
+        return it->second->second;
+    }
+
+    void Insert(const CInv& inv, const CSharedNetMsgPayloadPtr& payload)
+    {
+        size_t nSize = payload->data.size();
+        if (nSize > nMaxSize) {
+            return;
+        }
+        LOCK(cs);
+        Key key(inv.type, inv.hash);
+        if (index.count(key)) {
+            return;
+        }
+        lruList.emplace_front(key, payload);
+        index.emplace(key, lruList.begin());
+        nTotalSize += nSize;
+        while (nTotalSize > nMaxSize) {
+            auto& e = lruList.back();
+            nTotalSize -= e.second->data.size();
+            index.erase(e.first);
+            lruList.pop_back();
+        }
+    }
+};
+
+/** Maximum total size of the payloads in invPayloadCache */
+static const size_t MAX_INV_PAYLOAD_CACHE_SIZE = 32 * 1024 * 1024;
+CInvPayloadCache invPayloadCache(MAX_INV_PAYLOAD_CACHE_SIZE);
+
+/**
+ * Returns the serialized payload for inv from invPayloadCache, or serializes it through serializeFunc and caches it.
+ * Returns nullptr if serializeFunc failed.
+ */
+template<typename Callback>
+CSharedNetMsgPayloadPtr GetOrCreateInvPayload(const CInv& inv, Callback&& serializeFunc)
+{
+    auto payload = invPayloadCache.Get(inv);
+    if (payload) {
+        return payload;
+    }
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss.reserve(1000);
+    if (!serializeFunc(ss)) {
+        return nullptr;
+    }
+    payload = std::make_shared<const CSharedNetMsgPayload>(std::vector<unsigned char>(ss.begin(), ss.end()));
+    invPayloadCache.Insert(inv, payload);
+    return payload;
+}
+
+CSerializedNetMsg MakeSharedMsg(const std::string& command, CSharedNetMsgPayloadPtr payload)
+{
+    CSerializedNetMsg msg;
+    msg.command = command;
+    msg.sharedPayload = std::move(payload);
+    return msg;
+}
+} // namespace
+
 void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
 {
     AssertLockNotHeld(cs_main);
@@ -1319,37 +1486,29 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
 
             if (!push && inv.type == MSG_GOVERNANCE_OBJECT) {
                 LogPrint(BCLog::NET, "ProcessGetData -- MSG_GOVERNANCE_OBJECT: inv = %s\n", inv.ToString());
-                CDataStream ss(SER_NETWORK, pfrom->GetSendVersion());
-                bool topush = false;
-                {
-                    if(governance.HaveObjectForHash(inv.hash)) {
-                        ss.reserve(1000);
-                        if(governance.SerializeObjectForHash(inv.hash, ss)) {
-                            topush = true;
-                        }
-                    }
+                CSharedNetMsgPayloadPtr payload;
+                if(governance.HaveObjectForHash(inv.hash)) {
+                    payload = GetOrCreateInvPayload(inv, [&](CDataStream& ss) {
+                        return governance.SerializeObjectForHash(inv.hash, ss);
+                    });
                 }
-                LogPrint(BCLog::NET, "ProcessGetData -- MSG_GOVERNANCE_OBJECT: topush = %d, inv = %s\n", topush, inv.ToString());
-                if(topush) {
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNGOVERNANCEOBJECT, ss));
+                LogPrint(BCLog::NET, "ProcessGetData -- MSG_GOVERNANCE_OBJECT: topush = %d, inv = %s\n", payload != nullptr, inv.ToString());
+                if(payload) {
+                    connman->PushMessage(pfrom, MakeSharedMsg(NetMsgType::MNGOVERNANCEOBJECT, std::move(payload)));
                     push = true;
                 }
             }
 
             if (!push && inv.type == MSG_GOVERNANCE_OBJECT_VOTE) {
-                CDataStream ss(SER_NETWORK, pfrom->GetSendVersion());
-                bool topush = false;
-                {
-                    if(governance.HaveVoteForHash(inv.hash)) {
-                        ss.reserve(1000);
-                        if(governance.SerializeVoteForHash(inv.hash, ss)) {
-                            topush = true;
-                        }
-                    }
+                CSharedNetMsgPayloadPtr payload;
+                if(governance.HaveVoteForHash(inv.hash)) {
+                    payload = GetOrCreateInvPayload(inv, [&](CDataStream& ss) {
+                        return governance.SerializeVoteForHash(inv.hash, ss);
+                    });
                 }
-                if(topush) {
+                if(payload) {
                     LogPrint(BCLog::NET, "ProcessGetData -- pushing: inv = %s\n", inv.ToString());
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNGOVERNANCEOBJECTVOTE, ss));
+                    connman->PushMessage(pfrom, MakeSharedMsg(NetMsgType::MNGOVERNANCEOBJECTVOTE, std::move(payload)));
                     push = true;
                 }
             }
@@ -1677,15 +1836,15 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
     return true;
 }
 
-void static ProcessOrphanTx(CConnman* connman, std::set<uint256>& orphan_work_set) EXCLUSIVE_LOCKS_REQUIRED(cs_main, g_cs_orphans)
+void static ProcessOrphanTx(CConnman* connman, COrphanWorkSet& orphan_work_set) EXCLUSIVE_LOCKS_REQUIRED(cs_main, g_cs_orphans)
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(g_cs_orphans);
     std::set<NodeId> setMisbehaving;
     bool done = false;
     while (!done && !orphan_work_set.empty()) {
-        const uint256 orphanHash = *orphan_work_set.begin();
-        orphan_work_set.erase(orphan_work_set.begin());
+        // IS-locked orphans (or orphans of IS-locked parents) are resolved first
+        const uint256 orphanHash = orphan_work_set.pop();
 
         auto orphan_it = mapOrphanTransactions.find(orphanHash);
         if (orphan_it == mapOrphanTransactions.end()) continue;
@@ -1703,14 +1862,7 @@ void static ProcessOrphanTx(CConnman* connman, std::set<uint256>& orphan_work_se
         if (AcceptToMemoryPool(mempool, stateDummy, porphanTx, true, &fMissingInputs2)) {
             LogPrint(BCLog::MEMPOOL, "   accepted orphan tx %s\n", orphanHash.ToString());
             connman->RelayTransaction(orphanTx);
-            for (unsigned int i = 0; i < orphanTx.vout.size(); i++) {
-                auto it_by_prev = mapOrphanTransactionsByPrev.find(COutPoint(orphanHash, i));
-                if (it_by_prev != mapOrphanTransactionsByPrev.end()) {
-                    for (const auto& elem : it_by_prev->second) {
-                        orphan_work_set.insert(elem->first);
-                    }
-                }
-            }
+            AddOrphanChildrenToWorkSet(orphanTx, orphan_work_set, llmq::quorumInstantSendManager && llmq::quorumInstantSendManager->IsLocked(orphanHash));
             EraseOrphanTx(orphanHash);
             done = true;
         } else if (!fMissingInputs2) {
@@ -2512,14 +2664,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
 
             mempool.check(pcoinsTip);
             connman->RelayTransaction(tx);
-            for (unsigned int i = 0; i < tx.vout.size(); i++) {
-                auto it_by_prev = mapOrphanTransactionsByPrev.find(COutPoint(inv.hash, i));
-                if (it_by_prev != mapOrphanTransactionsByPrev.end()) {
-                    for (const auto& elem : it_by_prev->second) {
-                        pfrom->orphan_work_set.insert(elem->first);
-                    }
-                }
-            }
+            AddOrphanChildrenToWorkSet(tx, pfrom->orphan_work_set, llmq::quorumInstantSendManager && llmq::quorumInstantSendManager->IsLocked(inv.hash));
 
             pfrom->nLastTXTime = GetTime();
 
@@ -2712,8 +2857,14 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     }
                 }
 
+                // Only fetched when a reconstruction is actually attempted, as this copies the whole recent locks cache
+                std::vector<std::pair<uint256, CTransactionRef>> vLockedTxn;
+                if (llmq::quorumInstantSendManager) {
+                    vLockedTxn = llmq::quorumInstantSendManager->GetRecentLockedTxs();
+                }
+
                 PartiallyDownloadedBlock& partialBlock = *(*queuedBlockIt)->partialBlock;
-                ReadStatus status = partialBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = partialBlock.InitData(cmpctblock, vExtraTxnForCompact, vLockedTxn);
                 if (status == READ_STATUS_INVALID) {
                     MarkBlockAsReceived(pindex->GetBlockHash()); // Reset in-flight state in case of whitelist
                     Misbehaving(pfrom->GetId(), 100);
@@ -2724,6 +2875,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     std::vector<CInv> vInv(1);
                     vInv[0] = CInv(MSG_BLOCK, cmpctblock.header.GetHash());
                     connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::GETDATA, vInv));
+                    nCmpctBlocksFailed++;
                     return true;
                 }
 
@@ -2732,6 +2884,14 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     if (!partialBlock.IsTxAvailable(i))
                         req.indexes.push_back(i);
                 }
+                if (req.indexes.empty()) {
+                    nCmpctBlocksDirect++;
+                } else {
+                    nCmpctBlocksRoundTrip++;
+                }
+                LogPrint(BCLog::CMPCTBLOCK, "Compact block %s from peer=%d: %u txn from islock cache, %u txn missing (totals: %u without round trip, %u with getblocktxn, %u full block requests)\n",
+                         pindex->GetBlockHash().ToString(), pfrom->GetId(), partialBlock.GetLockedTxCount(), req.indexes.size(),
+                         nCmpctBlocksDirect, nCmpctBlocksRoundTrip, nCmpctBlocksFailed);
                 if (req.indexes.empty()) {
                     // Dirty hack to jump to BLOCKTXN code (TODO: move message handling into their own functions)
                     BlockTransactions txn;
@@ -2748,8 +2908,12 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                 // download from.
                 // Optimistically try to reconstruct anyway since we might be
                 // able to without any round trips.
+                std::vector<std::pair<uint256, CTransactionRef>> vLockedTxn;
+                if (llmq::quorumInstantSendManager) {
+                    vLockedTxn = llmq::quorumInstantSendManager->GetRecentLockedTxs();
+                }
                 PartiallyDownloadedBlock tempBlock(&mempool);
-                ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact, vLockedTxn);
                 if (status != READ_STATUS_OK) {
                     // TODO: don't ignore failures
                     return true;
@@ -3348,6 +3512,8 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
         LogPrintf("%s(%s, %u bytes) FAILED peer=%d\n", __func__, SanitizeString(strCommand), nMessageSize, pfrom->GetId());
     }
 
+    pfrom->RecycleMsgs(msgs);
+
     LOCK(cs_main);
     SendRejectsAndCheckIfBanned(pfrom, connman);
 
@@ -3706,7 +3872,7 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                     {
                         LOCK(cs_most_recent_block);
                         if (most_recent_block_hash == pBestIndex->GetBlockHash()) {
-                            connman->PushMessage(pto, msgMaker.Make(NetMsgType::CMPCTBLOCK, *most_recent_compact_block));
+                            PushCompactBlock(connman, pto, msgMaker, *most_recent_block, most_recent_compact_block.get());
                             fGotBlockFromCache = true;
                         }
                     }
@@ -3714,8 +3880,7 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                         CBlock block;
                         bool ret = ReadBlockFromDisk(block, pBestIndex, consensusParams);
                         assert(ret);
-                        CBlockHeaderAndShortTxIDs cmpctblock(block);
-                        connman->PushMessage(pto, msgMaker.Make(NetMsgType::CMPCTBLOCK, cmpctblock));
+                        PushCompactBlock(connman, pto, msgMaker, block, nullptr);
                     }
                     state.pindexBestHeaderSent = pBestIndex;
                 } else if (state.fPreferHeaders) {
@@ -4050,6 +4215,8 @@ public:
         // orphan transactions
         mapOrphanTransactions.clear();
         mapOrphanTransactionsByPrev.clear();
+        mapOrphanTransactionsByPeer.clear();
+        vOrphanList.clear();
         nMapOrphanTransactionsSize = 0;
     }
 } instance_of_cnetprocessingcleanup;
@@ -53,6 +53,7 @@ const char *DSQUEUE="dsq";
 const char *SENDDSQUEUE="senddsq";
 const char *SYNCSTATUSCOUNT="ssc";
 const char *MNGOVERNANCESYNC="govsync";
+const char *MNGOVERNANCERECON="govrecon";
 const char *MNGOVERNANCEOBJECT="govobj";
 const char *MNGOVERNANCEOBJECTVOTE="govobjvote";
 const char *GETMNLISTDIFF="getmnlistd";
@@ -119,6 +120,7 @@ const static std::string allNetMessageTypes[] = {
     NetMsgType::DSQUEUE,
     NetMsgType::SYNCSTATUSCOUNT,
     NetMsgType::MNGOVERNANCESYNC,
+    NetMsgType::MNGOVERNANCERECON,
     NetMsgType::MNGOVERNANCEOBJECT,
     NetMsgType::MNGOVERNANCEOBJECTVOTE,
     NetMsgType::GETMNLISTDIFF,
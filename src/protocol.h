@@ -253,6 +253,7 @@ extern const char *DSQUEUE;
 extern const char *SENDDSQUEUE;
 extern const char *SYNCSTATUSCOUNT;
 extern const char *MNGOVERNANCESYNC;
+extern const char *MNGOVERNANCERECON;
 extern const char *MNGOVERNANCEOBJECT;
 extern const char *MNGOVERNANCEOBJECTVOTE;
 extern const char *GETMNLISTDIFF;
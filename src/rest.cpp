@@ -18,6 +18,11 @@
 #include "utilstrencodings.h"
 #include "version.h"
 
+#include "evo/deterministicmns.h"
+#include "llmq/quorums.h"
+#include "llmq/quorums_chainlocks.h"
+#include "llmq/quorums_instantsend.h"
+
 #include <boost/algorithm/string.hpp>
 
 #include <univalue.h>
@@ -586,6 +591,183 @@ static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
     return true; // continue to process further HTTP reqs on this cxn
 }
 
+/** Writes the serialized object in the requested format. toJSON is only invoked for json requests */
+static bool RESTWriteSerialized(HTTPRequest* req, const RetFormat rf, const CDataStream& ss, const std::function<UniValue()>& toJSON)
+{
+    switch (rf) {
+    case RF_BINARY: {
+        std::string binary = ss.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binary);
+        return true;
+    }
+
+    case RF_HEX: {
+        std::string strHex = HexStr(ss.begin(), ss.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        std::string strJSON = toJSON().write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
+static bool rest_mnlist(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string hashStr;
+    const RetFormat rf = ParseDataFormat(hashStr, strURIPart);
+
+    uint256 hash;
+    if (!ParseHashStr(hashStr, hash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+
+    CDeterministicMNList mnList;
+    {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(hash);
+        if (it == mapBlockIndex.end() || !chainActive.Contains(it->second))
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        mnList = deterministicMNManager->GetListForBlock(it->second);
+    }
+
+    // Serialized the same way as in evodb: block hash, height, total registered count and all CDeterministicMN entries
+    CDataStream ssMNList(SER_NETWORK, PROTOCOL_VERSION);
+    if (rf != RF_JSON) {
+        ssMNList << mnList;
+    }
+
+    return RESTWriteSerialized(req, rf, ssMNList, [&]() {
+        UniValue objMNList(UniValue::VOBJ);
+        objMNList.push_back(Pair("blockHash", mnList.GetBlockHash().ToString()));
+        objMNList.push_back(Pair("height", mnList.GetHeight()));
+        objMNList.push_back(Pair("totalRegisteredCount", (int64_t)mnList.GetTotalRegisteredCount()));
+        UniValue mns(UniValue::VARR);
+        mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+            UniValue obj;
+            dmn->ToJson(obj);
+            obj.push_back(Pair("valid", mnList.IsMNValid(dmn)));
+            mns.push_back(obj);
+        });
+        objMNList.push_back(Pair("mns", mns));
+        return objMNList;
+    });
+}
+
+// Defined in rpc/rpcquorums.cpp
+UniValue BuildQuorumInfo(const llmq::CQuorumCPtr& quorum, bool includeMembers, bool includeSkShare);
+
+static bool rest_quorums(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string typeStr;
+    const RetFormat rf = ParseDataFormat(typeStr, strURIPart);
+
+    int32_t type;
+    if (!ParseInt32(typeStr, &type) || !Params().GetConsensus().llmqs.count((Consensus::LLMQType)type))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid LLMQ type: " + typeStr);
+    const auto& llmqParams = Params().GetConsensus().llmqs.at((Consensus::LLMQType)type);
+
+    std::vector<llmq::CQuorumCPtr> quorums;
+    {
+        LOCK(cs_main);
+        quorums = llmq::quorumManager->ScanQuorums(llmqParams.type, chainActive.Tip(), llmqParams.signingActiveQuorumCount);
+    }
+
+    // A quorum is fully described by its final commitment, so we send the list of active commitments
+    CDataStream ssQuorums(SER_NETWORK, PROTOCOL_VERSION);
+    if (rf != RF_JSON) {
+        WriteCompactSize(ssQuorums, quorums.size());
+        for (const auto& quorum : quorums) {
+            ssQuorums << quorum->qc;
+        }
+    }
+
+    return RESTWriteSerialized(req, rf, ssQuorums, [&]() {
+        UniValue arrQuorums(UniValue::VARR);
+        for (const auto& quorum : quorums) {
+            arrQuorums.push_back(BuildQuorumInfo(quorum, false, false));
+        }
+        return arrQuorums;
+    });
+}
+
+static bool rest_islock(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string hashStr;
+    const RetFormat rf = ParseDataFormat(hashStr, strURIPart);
+
+    uint256 txid;
+    if (!ParseHashStr(hashStr, txid))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+
+    uint256 islockHash;
+    llmq::CInstantSendLock islock;
+    if (!llmq::quorumInstantSendManager->GetInstantSendLockHashByTxid(txid, islockHash) ||
+        !llmq::quorumInstantSendManager->GetInstantSendLockByHash(islockHash, islock))
+        return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+
+    CDataStream ssISLock(SER_NETWORK, PROTOCOL_VERSION);
+    if (rf != RF_JSON) {
+        ssISLock << islock;
+    }
+
+    return RESTWriteSerialized(req, rf, ssISLock, [&]() {
+        UniValue objISLock(UniValue::VOBJ);
+        objISLock.push_back(Pair("txid", islock.txid.ToString()));
+        UniValue inputs(UniValue::VARR);
+        for (const auto& in : islock.inputs) {
+            UniValue objIn(UniValue::VOBJ);
+            objIn.push_back(Pair("txid", in.hash.ToString()));
+            objIn.push_back(Pair("vout", (int64_t)in.n));
+            inputs.push_back(objIn);
+        }
+        objISLock.push_back(Pair("inputs", inputs));
+        objISLock.push_back(Pair("hash", islockHash.ToString()));
+        objISLock.push_back(Pair("signature", islock.sig.Get().ToString()));
+        return objISLock;
+    });
+}
+
+static bool rest_chainlock(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+
+    llmq::CChainLockSig clsig = llmq::chainLocksHandler->GetBestChainLock();
+    if (clsig.IsNull())
+        return RESTERR(req, HTTP_NOT_FOUND, "no chainlock known");
+
+    CDataStream ssCLSig(SER_NETWORK, PROTOCOL_VERSION);
+    if (rf != RF_JSON) {
+        ssCLSig << clsig;
+    }
+
+    return RESTWriteSerialized(req, rf, ssCLSig, [&]() {
+        UniValue objCLSig(UniValue::VOBJ);
+        objCLSig.push_back(Pair("height", clsig.nHeight));
+        objCLSig.push_back(Pair("blockhash", clsig.blockHash.ToString()));
+        objCLSig.push_back(Pair("signature", clsig.sig.ToString()));
+        return objCLSig;
+    });
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(HTTPRequest* req, const std::string& strReq);
@@ -598,6 +780,10 @@ static const struct {
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
+      {"/rest/mnlist/", rest_mnlist},
+      {"/rest/quorums/", rest_quorums},
+      {"/rest/islock/", rest_islock},
+      {"/rest/chainlock", rest_chainlock},
 };
 
 bool StartREST()
@@ -0,0 +1,107 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DASH_RING_BUFFER_H
+#define DASH_RING_BUFFER_H
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+/**
+ * A bounded, lock-free ring buffer which allows multiple producers and a single consumer.
+ *
+ * Producers claim a slot by advancing the write position with a CAS and then publish the value through the sequence
+ * number of the slot. try_push never blocks and fails if the buffer is full. try_pop must only be called from one
+ * thread at a time.
+ */
+template<typename T>
+class mpsc_ring_buffer
+{
+private:
+    struct Slot {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    // padded to separate cache lines, as producers and the consumer update these concurrently
+    std::atomic<size_t> writePos{0};
+    char padding[64];
+    size_t readPos{0};
+
+    static size_t RoundUpCapacity(size_t capacity)
+    {
+        // rounding up would overflow otherwise
+        assert(capacity <= std::numeric_limits<size_t>::max() / 2 + 1);
+        size_t ret = 2;
+        while (ret < capacity) {
+            ret <<= 1;
+        }
+        return ret;
+    }
+
+public:
+    // capacity is rounded up to the next power of two
+    explicit mpsc_ring_buffer(size_t _capacity) :
+        mask(RoundUpCapacity(_capacity) - 1),
+        slots(new Slot[mask + 1])
+    {
+        for (size_t i = 0; i <= mask; i++) {
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_ring_buffer(const mpsc_ring_buffer&) = delete;
+    mpsc_ring_buffer& operator=(const mpsc_ring_buffer&) = delete;
+
+    bool try_push(T&& v)
+    {
+        size_t pos = writePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[pos & mask];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(v);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // pos was updated by compare_exchange_weak
+            } else if (diff < 0) {
+                // the consumer did not free this slot yet
+                return false;
+            } else {
+                pos = writePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& v)
+    {
+        Slot& slot = slots[readPos & mask];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(readPos + 1) < 0) {
+            // empty or the producer of this slot did not publish yet
+            return false;
+        }
+        v = std::move(slot.value);
+        slot.value = T();
+        slot.seq.store(readPos + mask + 1, std::memory_order_release);
+        readPos++;
+        return true;
+    }
+
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+};
+
+#endif // DASH_RING_BUFFER_H
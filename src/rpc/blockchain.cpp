@@ -27,6 +27,7 @@
 #include "util.h"
 #include "utilstrencodings.h"
 #include "hash.h"
+#include "indexer.h"
 
 #include "evo/specialtx.h"
 #include "evo/cbtx.h"
@@ -675,6 +676,10 @@ UniValue getblockhashes(const JSONRPCRequest& request)
             + HelpExampleRpc("getblockhashes", "1231614698, 1231024505")
         );
 
+    if (g_indexer) {
+        g_indexer->BlockUntilSyncedToCurrentChain();
+    }
+
     unsigned int high = request.params[0].get_int();
     unsigned int low = request.params[1].get_int();
     std::vector<uint256> blockHashes;
@@ -10,6 +10,7 @@
 #include "core_io.h"
 #include "init.h"
 #include "httpserver.h"
+#include "indexer.h"
 #include "net.h"
 #include "netbase.h"
 #include "rpc/blockchain.h"
@@ -711,6 +712,83 @@ bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> a,
     return a.second.time < b.second.time;
 }
 
+// Returns true if the caller requested a single page of results by passing "limit" (and optionally "cursor")
+bool getPagingFromParams(const UniValue& params, size_t& limit, UniValue& cursor)
+{
+    if (!params[0].isObject()) {
+        return false;
+    }
+    UniValue limitValue = find_value(params[0].get_obj(), "limit");
+    if (limitValue.isNull()) {
+        return false;
+    }
+    if (!limitValue.isNum() || limitValue.get_int() <= 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "limit is expected to be a positive number");
+    }
+    limit = limitValue.get_int();
+    cursor = find_value(params[0].get_obj(), "cursor");
+    if (!cursor.isNull() && !cursor.isObject()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "cursor is expected to be an object");
+    }
+    return true;
+}
+
+/**
+ * Reads a single page of address index entries of all addresses, which contains the entries of at most "limit"
+ * transactions (ordered by height and position in the block), starting at the transaction at (startHeight, startTxIndex).
+ * next is set to the cursor of the following page or stays null if this is the last page.
+ */
+void getAddressIndexPage(const std::vector<std::pair<uint160, int> >& addresses, int startHeight, unsigned int startTxIndex, int end, size_t limit,
+                         std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex, UniValue& next)
+{
+    // If the page of an address is truncated, entries of other addresses after its last transaction can't be returned
+    // in this page, as the truncated address might have entries in between
+    bool fTruncated = false;
+    std::pair<int, unsigned int> boundary(0, 0);
+
+    std::vector<std::pair<CAddressIndexKey, CAmount> > entries;
+    for (const auto& address : addresses) {
+        size_t oldSize = entries.size();
+        bool fMore;
+        if (!GetAddressIndexPage(address.first, address.second, startHeight, startTxIndex, end, limit, entries, fMore)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        if (fMore && entries.size() != oldSize) {
+            auto last = std::make_pair(entries.back().first.blockHeight, entries.back().first.txindex);
+            if (!fTruncated || last < boundary) {
+                boundary = last;
+            }
+            fTruncated = true;
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const std::pair<CAddressIndexKey, CAmount>& a, const std::pair<CAddressIndexKey, CAmount>& b) {
+        return std::make_pair(a.first.blockHeight, a.first.txindex) < std::make_pair(b.first.blockHeight, b.first.txindex);
+    });
+
+    size_t txCount = 0;
+    std::pair<int, unsigned int> lastTx(-1, 0);
+    for (const auto& entry : entries) {
+        auto tx = std::make_pair(entry.first.blockHeight, entry.first.txindex);
+        if (tx != lastTx) {
+            if (txCount == limit || (fTruncated && boundary < tx)) {
+                next = UniValue(UniValue::VOBJ);
+                next.push_back(Pair("height", tx.first));
+                next.push_back(Pair("blockindex", (int)tx.second));
+                return;
+            }
+            txCount++;
+            lastTx = tx;
+        }
+        addressIndex.push_back(entry);
+    }
+    if (fTruncated) {
+        next = UniValue(UniValue::VOBJ);
+        next.push_back(Pair("height", boundary.first));
+        next.push_back(Pair("blockindex", (int)boundary.second + 1));
+    }
+}
+
 UniValue getaddressmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -795,6 +873,8 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
             "      \"address\"  (string) The base58check encoded address\n"
             "      ,...\n"
             "    ]\n"
+            "  \"limit\" (number, optional) Only return a single page of at most this many outputs\n"
+            "  \"cursor\" (object, optional) The \"next\" value of the previous page\n"
             "}\n"
             "\nResult:\n"
             "[\n"
@@ -807,11 +887,21 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
             "    \"height\"  (number) The block height\n"
             "  }\n"
             "]\n"
+            "\nResult (when \"limit\" is passed):\n"
+            "{\n"
+            "  \"utxos\"  (array) The outputs of this page as above, ordered by address, txid and output index\n"
+            "  \"next\"  (object) The cursor of the next page or null if this is the last one\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+            + HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
             + HelpExampleRpc("getaddressutxos", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
+    if (g_indexer) {
+        g_indexer->BlockUntilSyncedToCurrentChain();
+    }
+
     std::vector<std::pair<uint160, int> > addresses;
 
     if (!getAddressesFromParams(request.params, addresses)) {
@@ -820,13 +910,63 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
 
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressUnspent((*it).first, (*it).second, unspentOutputs)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    size_t limit;
+    UniValue cursor;
+    bool fPaging = getPagingFromParams(request.params, limit, cursor);
+    UniValue next;
+
+    if (fPaging) {
+        // Pages are returned in DB order, so that we never have to read more than a single page from the index
+        size_t addressPos = 0;
+        uint256 startTxHash;
+        size_t startIndex = 0;
+        if (!cursor.isNull()) {
+            std::string cursorAddress = find_value(cursor.get_obj(), "address").get_str();
+            for (addressPos = 0; addressPos < addresses.size(); addressPos++) {
+                std::string address;
+                if (getAddressFromIndex(addresses[addressPos].second, addresses[addressPos].first, address) && address == cursorAddress) {
+                    break;
+                }
+            }
+            if (addressPos == addresses.size()) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "cursor does not match any of the addresses");
+            }
+            startTxHash = ParseHashV(find_value(cursor.get_obj(), "txid"), "txid");
+            startIndex = find_value(cursor.get_obj(), "outputIndex").get_int();
         }
-    }
 
-    std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
+        for (; addressPos < addresses.size(); addressPos++) {
+            // read one more output than needed, which is the first one of the next page
+            bool fMore;
+            if (!GetAddressUnspentPage(addresses[addressPos].first, addresses[addressPos].second, startTxHash, startIndex,
+                                       limit + 1 - unspentOutputs.size(), unspentOutputs, fMore)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+            if (unspentOutputs.size() > limit) {
+                const auto& nextKey = unspentOutputs.back().first;
+                std::string address;
+                if (!getAddressFromIndex(nextKey.type, nextKey.hashBytes, address)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+                }
+                next = UniValue(UniValue::VOBJ);
+                next.push_back(Pair("address", address));
+                next.push_back(Pair("txid", nextKey.txhash.GetHex()));
+                next.push_back(Pair("outputIndex", (int)nextKey.index));
+                unspentOutputs.pop_back();
+                break;
+            }
+            startTxHash.SetNull();
+            startIndex = 0;
+        }
+    } else {
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (!GetAddressUnspent((*it).first, (*it).second, unspentOutputs)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+        }
+
+        std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
+    }
 
     UniValue result(UniValue::VARR);
 
@@ -846,6 +986,13 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
         result.push_back(output);
     }
 
+    if (fPaging) {
+        UniValue page(UniValue::VOBJ);
+        page.push_back(Pair("utxos", result));
+        page.push_back(Pair("next", next));
+        return page;
+    }
+
     return result;
 }
 
@@ -864,6 +1011,8 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
             "    ]\n"
             "  \"start\" (number) The start block height\n"
             "  \"end\" (number) The end block height\n"
+            "  \"limit\" (number, optional) Only return a single page with the deltas of at most this many transactions\n"
+            "  \"cursor\" (object, optional) The \"next\" value of the previous page\n"
             "}\n"
             "\nResult:\n"
             "[\n"
@@ -876,11 +1025,20 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
             "    \"address\"  (string) The base58check encoded address\n"
             "  }\n"
             "]\n"
+            "\nResult (when \"limit\" is passed):\n"
+            "{\n"
+            "  \"deltas\"  (array) The deltas of this page as above\n"
+            "  \"next\"  (object) The cursor of the next page or null if this is the last one\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+            + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
             + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
+    if (g_indexer) {
+        g_indexer->BlockUntilSyncedToCurrentChain();
+    }
 
     UniValue startValue = find_value(request.params[0].get_obj(), "start");
     UniValue endValue = find_value(request.params[0].get_obj(), "end");
@@ -904,14 +1062,29 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
 
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    size_t limit;
+    UniValue cursor;
+    bool fPaging = getPagingFromParams(request.params, limit, cursor);
+    UniValue next;
+
+    if (fPaging) {
+        int startHeight = start > 0 && end > 0 ? start : 0;
+        unsigned int startTxIndex = 0;
+        if (!cursor.isNull()) {
+            startHeight = find_value(cursor.get_obj(), "height").get_int();
+            startTxIndex = find_value(cursor.get_obj(), "blockindex").get_int();
+        }
+        getAddressIndexPage(addresses, startHeight, startTxIndex, start > 0 && end > 0 ? end : 0, limit, addressIndex, next);
+    } else {
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (start > 0 && end > 0) {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+            } else {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
             }
         }
     }
@@ -934,6 +1107,13 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         result.push_back(delta);
     }
 
+    if (fPaging) {
+        UniValue page(UniValue::VOBJ);
+        page.push_back(Pair("deltas", result));
+        page.push_back(Pair("next", next));
+        return page;
+    }
+
     return result;
 }
 
@@ -955,39 +1135,80 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
             "{\n"
             "  \"balance\"  (string) The current balance in duffs\n"
             "  \"received\"  (string) The total number of duffs received (including change)\n"
+            "  \"txcount\"  (number) The number of transactions spending from or paying to the address(es),\n"
+            "                         counted once per address\n"
+            "  \"firstheight\"  (number) The height of the first block with such a transaction, -1 if there is none\n"
+            "  \"lastheight\"  (number) The height of the last block with such a transaction, -1 if there is none\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressbalance", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
             + HelpExampleRpc("getaddressbalance", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
+    if (g_indexer) {
+        g_indexer->BlockUntilSyncedToCurrentChain();
+    }
+
     std::vector<std::pair<uint160, int> > addresses;
 
     if (!getAddressesFromParams(request.params, addresses)) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    CAmount balance = 0;
+    CAmount received = 0;
+    uint64_t txCount = 0;
+    int firstHeight = -1;
+    int lastHeight = -1;
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    auto updateHeights = [&](int nFirst, int nLast) {
+        if (firstHeight == -1 || nFirst < firstHeight) {
+            firstHeight = nFirst;
         }
-    }
+        lastHeight = std::max(lastHeight, nLast);
+    };
 
-    CAmount balance = 0;
-    CAmount received = 0;
+    if (fAddressBalanceIndex) {
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            CAddressBalanceValue value;
+            if (!GetAddressBalance((*it).first, (*it).second, value)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+            balance += value.balance;
+            received += value.received;
+            if (!value.IsNull()) {
+                txCount += value.txCount;
+                updateHeights(value.firstHeight, value.lastHeight);
+            }
+        }
+    } else {
+        // address index was built without the balance index, so we have to sum up the whole history
+        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        if (it->second > 0) {
-            received += it->second;
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+        }
+
+        std::set<std::pair<uint160, uint256> > txids;
+        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
+            if (it->second > 0) {
+                received += it->second;
+            }
+            balance += it->second;
+            txids.emplace(it->first.hashBytes, it->first.txhash);
+            updateHeights(it->first.blockHeight, it->first.blockHeight);
         }
-        balance += it->second;
+        txCount = txids.size();
     }
 
     UniValue result(UniValue::VOBJ);
     result.push_back(Pair("balance", balance));
     result.push_back(Pair("received", received));
+    result.push_back(Pair("txcount", txCount));
+    result.push_back(Pair("firstheight", firstHeight));
+    result.push_back(Pair("lastheight", lastHeight));
 
     return result;
 
@@ -1008,17 +1229,29 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
             "    ]\n"
             "  \"start\" (number) The start block height\n"
             "  \"end\" (number) The end block height\n"
+            "  \"limit\" (number, optional) Only return a single page of at most this many txids\n"
+            "  \"cursor\" (object, optional) The \"next\" value of the previous page\n"
             "}\n"
             "\nResult:\n"
             "[\n"
             "  \"transactionid\"  (string) The transaction id\n"
             "  ,...\n"
             "]\n"
+            "\nResult (when \"limit\" is passed):\n"
+            "{\n"
+            "  \"txids\"  (array) The txids of this page as above\n"
+            "  \"next\"  (object) The cursor of the next page or null if this is the last one\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+            + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
             + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
+    if (g_indexer) {
+        g_indexer->BlockUntilSyncedToCurrentChain();
+    }
+
     std::vector<std::pair<uint160, int> > addresses;
 
     if (!getAddressesFromParams(request.params, addresses)) {
@@ -1038,14 +1271,29 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
 
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    size_t limit;
+    UniValue cursor;
+    bool fPaging = getPagingFromParams(request.params, limit, cursor);
+    UniValue next;
+
+    if (fPaging) {
+        int startHeight = start > 0 && end > 0 ? start : 0;
+        unsigned int startTxIndex = 0;
+        if (!cursor.isNull()) {
+            startHeight = find_value(cursor.get_obj(), "height").get_int();
+            startTxIndex = find_value(cursor.get_obj(), "blockindex").get_int();
+        }
+        getAddressIndexPage(addresses, startHeight, startTxIndex, start > 0 && end > 0 ? end : 0, limit, addressIndex, next);
+    } else {
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (start > 0 && end > 0) {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+            } else {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
             }
         }
     }
@@ -1072,6 +1320,13 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
         }
     }
 
+    if (fPaging) {
+        UniValue page(UniValue::VOBJ);
+        page.push_back(Pair("txids", result));
+        page.push_back(Pair("next", next));
+        return page;
+    }
+
     return result;
 
 }
@@ -1098,6 +1353,10 @@ UniValue getspentinfo(const JSONRPCRequest& request)
             + HelpExampleRpc("getspentinfo", "{\"txid\": \"0437cd7f8525ceed2324359c2d0ba26006d92d856a9c20fa0241106ee5a597c9\", \"index\": 0}")
         );
 
+    if (g_indexer) {
+        g_indexer->BlockUntilSyncedToCurrentChain();
+    }
+
     UniValue txidValue = find_value(request.params[0].get_obj(), "txid");
     UniValue indexValue = find_value(request.params[0].get_obj(), "index");
 
@@ -10,6 +10,7 @@
 #include "consensus/validation.h"
 #include "core_io.h"
 #include "init.h"
+#include "indexer.h"
 #include "keystore.h"
 #include "validation.h"
 #include "merkleblock.h"
@@ -174,6 +175,10 @@ UniValue getrawtransaction(const JSONRPCRequest& request)
             + HelpExampleRpc("getrawtransaction", "\"mytxid\", true")
         );
 
+    if (g_indexer) {
+        g_indexer->BlockUntilSyncedToCurrentChain();
+    }
+
     LOCK(cs_main);
 
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
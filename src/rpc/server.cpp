@@ -8,6 +8,7 @@
 
 #include "base58.h"
 #include "fs.h"
+#include "httpserver.h"
 #include "init.h"
 #include "random.h"
 #include "sync.h"
@@ -325,6 +326,47 @@ UniValue uptime(const JSONRPCRequest& jsonRequest)
     return GetTime() - GetStartupTime();
 }
 
+UniValue getrpcinfo(const JSONRPCRequest& jsonRequest)
+{
+    if (jsonRequest.fHelp || jsonRequest.params.size() > 0)
+        throw std::runtime_error(
+                "getrpcinfo\n"
+                        "\nReturns statistics about the HTTP/RPC work queues.\n"
+                        "\nResult:\n"
+                        "[\n"
+                        "  {\n"
+                        "    \"name\": \"xxxx\",            (string) The name of the work queue (fast, heavy or wallet)\n"
+                        "    \"threads\": n,              (numeric) The number of worker threads\n"
+                        "    \"depth\": n,                (numeric) The number of currently queued requests\n"
+                        "    \"maxdepth\": n,             (numeric) The maximum number of queued requests\n"
+                        "    \"processed\": n,            (numeric) The number of requests picked up by a worker\n"
+                        "    \"rejected\": n,             (numeric) The number of requests rejected because the queue was full\n"
+                        "    \"avgqueuetime\": n,         (numeric) The average time in microseconds requests waited in the queue\n"
+                        "    \"maxqueuetime\": n          (numeric) The maximum time in microseconds a request waited in the queue\n"
+                        "  },\n"
+                        "  ...\n"
+                        "]\n"
+                        "\nExamples:\n"
+                + HelpExampleCli("getrpcinfo", "")
+                + HelpExampleRpc("getrpcinfo", "")
+        );
+
+    UniValue ret(UniValue::VARR);
+    for (const auto& stats : GetHTTPWorkQueueStats()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("name", stats.name));
+        obj.push_back(Pair("threads", stats.threads));
+        obj.push_back(Pair("depth", (uint64_t)stats.depth));
+        obj.push_back(Pair("maxdepth", (uint64_t)stats.maxDepth));
+        obj.push_back(Pair("processed", stats.processed));
+        obj.push_back(Pair("rejected", stats.rejected));
+        obj.push_back(Pair("avgqueuetime", stats.processed ? stats.totalQueueTime / (int64_t)stats.processed : 0));
+        obj.push_back(Pair("maxqueuetime", stats.maxQueueTime));
+        ret.push_back(obj);
+    }
+    return ret;
+}
+
 /**
  * Call Table
  */
@@ -335,6 +377,7 @@ static const CRPCCommand vRPCCommands[] =
     { "control",            "help",                   &help,                   true,  {"command"}  },
     { "control",            "stop",                   &stop,                   true,  {"wait"}  },
     { "control",            "uptime",                 &uptime,                 true,  {}  },
+    { "control",            "getrpcinfo",             &getrpcinfo,             true,  {}  },
 };
 
 CRPCTable::CRPCTable()
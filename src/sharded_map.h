@@ -0,0 +1,195 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DASH_SHARDED_MAP_H
+#define DASH_SHARDED_MAP_H
+
+#include "sync.h"
+
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * A thread-safe hash map which is split into multiple shards, each guarded by its own lock. Keys are assigned to
+ * shards by their hash, so that concurrent accesses to different keys usually don't contend on the same lock.
+ *
+ * Callbacks passed to update/for_each/erase_if are invoked while the lock of the corresponding shard is held, so they
+ * must not call back into the same map.
+ */
+template<typename Key, typename Value, typename Hasher = std::hash<Key>, size_t ShardCount = 16>
+class sharded_map
+{
+private:
+    typedef std::unordered_map<Key, Value, Hasher> MapType;
+
+    struct Shard {
+        mutable CCriticalSection cs;
+        MapType map;
+    };
+
+    std::array<Shard, ShardCount> shards;
+    Hasher hasher;
+
+    Shard& GetShard(const Key& key)
+    {
+        return shards[hasher(key) % ShardCount];
+    }
+    const Shard& GetShard(const Key& key) const
+    {
+        return shards[hasher(key) % ShardCount];
+    }
+
+public:
+    // returns false if the key was already present, in which case the old value is kept
+    bool emplace(const Key& key, const Value& v)
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        return shard.map.emplace(key, v).second;
+    }
+
+    void insert_or_assign(const Key& key, const Value& v)
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        shard.map[key] = v;
+    }
+
+    bool get(const Key& key, Value& value) const
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    bool exists(const Key& key) const
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        return shard.map.count(key) != 0;
+    }
+
+    // Invokes func(Value&) on the entry of key. If key is not present and createIfMissing is set, a default constructed
+    // entry is created first
+    template<typename Callback>
+    bool update(const Key& key, Callback&& func, bool createIfMissing = false)
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            if (!createIfMissing) {
+                return false;
+            }
+            it = shard.map.emplace(key, Value()).first;
+        }
+        func(it->second);
+        return true;
+    }
+
+    // Invokes func(const Value&) on the entry of key, if present
+    template<typename Callback>
+    bool visit(const Key& key, Callback&& func) const
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        func(it->second);
+        return true;
+    }
+
+    // Invokes func(Value&) on the entry of key, if present, and erases the entry if func returned true
+    template<typename Callback>
+    bool update_erase_if(const Key& key, Callback&& func)
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        if (func(it->second)) {
+            shard.map.erase(it);
+        }
+        return true;
+    }
+
+    bool erase(const Key& key)
+    {
+        auto& shard = GetShard(key);
+        LOCK(shard.cs);
+        return shard.map.erase(key) != 0;
+    }
+
+    // Invokes func(const Key&, Value&) for every entry and erases the ones for which func returned true
+    template<typename Callback>
+    size_t erase_if(Callback&& func)
+    {
+        size_t cnt = 0;
+        for (auto& shard : shards) {
+            LOCK(shard.cs);
+            for (auto it = shard.map.begin(); it != shard.map.end(); ) {
+                if (func(it->first, it->second)) {
+                    it = shard.map.erase(it);
+                    cnt++;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return cnt;
+    }
+
+    // Invokes func(const Key&, const Value&) for every entry. Only one shard is locked at a time, so this is not an
+    // atomic view of the whole map
+    template<typename Callback>
+    void for_each(Callback&& func) const
+    {
+        for (auto& shard : shards) {
+            LOCK(shard.cs);
+            for (auto& p : shard.map) {
+                func(p.first, p.second);
+            }
+        }
+    }
+
+    std::vector<std::pair<Key, Value>> snapshot() const
+    {
+        std::vector<std::pair<Key, Value>> ret;
+        for_each([&](const Key& k, const Value& v) {
+            ret.emplace_back(k, v);
+        });
+        return ret;
+    }
+
+    size_t size() const
+    {
+        size_t cnt = 0;
+        for (auto& shard : shards) {
+            LOCK(shard.cs);
+            cnt += shard.map.size();
+        }
+        return cnt;
+    }
+
+    void clear()
+    {
+        for (auto& shard : shards) {
+            LOCK(shard.cs);
+            shard.map.clear();
+        }
+    }
+};
+
+#endif // DASH_SHARDED_MAP_H
@@ -10,6 +10,7 @@
 #include "amount.h"
 #include "script/script.h"
 #include "serialize.h"
+#include "saltedhasher.h"
 
 struct CSpentIndexKey {
     uint256 txid;
@@ -37,6 +38,15 @@ struct CSpentIndexKey {
         outputIndex = 0;
     }
 
+    bool operator==(const CSpentIndexKey& other) const {
+        return txid == other.txid && outputIndex == other.outputIndex;
+    }
+};
+
+struct CSpentIndexKeyHasher {
+    std::size_t operator()(const CSpentIndexKey& key) const {
+        return SipHashUint256Extra(StaticSaltedHasher::s.k0, StaticSaltedHasher::s.k1, key.txid, key.outputIndex);
+    }
 };
 
 struct CSpentIndexValue {
@@ -375,5 +385,84 @@ struct CAddressIndexIteratorHeightKey {
     }
 };
 
+struct CAddressIndexIteratorTxKey {
+    unsigned int type;
+    uint160 hashBytes;
+    int blockHeight;
+    unsigned int txindex;
+
+    size_t GetSerializeSize(int nType, int nVersion) const {
+        return 29;
+    }
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        ser_writedata8(s, type);
+        hashBytes.Serialize(s);
+        ser_writedata32be(s, blockHeight);
+        ser_writedata32be(s, txindex);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        type = ser_readdata8(s);
+        hashBytes.Unserialize(s);
+        blockHeight = ser_readdata32be(s);
+        txindex = ser_readdata32be(s);
+    }
+
+    CAddressIndexIteratorTxKey(unsigned int addressType, uint160 addressHash, int height, unsigned int blockindex) {
+        type = addressType;
+        hashBytes = addressHash;
+        blockHeight = height;
+        txindex = blockindex;
+    }
+
+    CAddressIndexIteratorTxKey() {
+        SetNull();
+    }
+
+    void SetNull() {
+        type = 0;
+        hashBytes.SetNull();
+        blockHeight = 0;
+        txindex = 0;
+    }
+};
+
+// Aggregated values of all address index entries of a single address (keyed by CAddressIndexIteratorKey)
+struct CAddressBalanceValue {
+    CAmount balance;
+    CAmount received;
+    uint32_t txCount;
+    int firstHeight;
+    int lastHeight;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(balance);
+        READWRITE(received);
+        READWRITE(txCount);
+        READWRITE(firstHeight);
+        READWRITE(lastHeight);
+    }
+
+    CAddressBalanceValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+        txCount = 0;
+        firstHeight = -1;
+        lastHeight = -1;
+    }
+
+    bool IsNull() const {
+        return (txCount == 0);
+    }
+};
+
 
 #endif // BITCOIN_SPENTINDEX_H
@@ -524,6 +524,7 @@ static void PrintCrashInfo(const crash_info& ci)
 {
     auto str = GetCrashInfoStr(ci);
     LogPrintf("%s", str);
+    FlushDebugLog();
     fprintf(stderr, "%s", str.c_str());
     fflush(stderr);
 }
@@ -28,8 +28,14 @@ struct COrphanTx {
     CTransactionRef tx;
     NodeId fromPeer;
     int64_t nTimeExpire;
+    size_t nTxSize;
+    size_t nListPos;
+    bool fISLocked;
 };
-extern std::map<uint256, COrphanTx> mapOrphanTransactions;
+extern std::unordered_map<uint256, COrphanTx, StaticSaltedHasher> mapOrphanTransactions;
+extern std::unordered_map<NodeId, std::set<uint256>> mapOrphanTransactionsByPeer;
+extern std::vector<uint256> vOrphanList;
+extern void AddOrphanChildrenToWorkSet(const CTransaction& tx, COrphanWorkSet& orphan_work_set, bool fParentLocked);
 
 CService ip(uint32_t i)
 {
@@ -265,11 +271,7 @@ BOOST_AUTO_TEST_CASE(DoS_bantime)
 
 CTransactionRef RandomOrphan()
 {
-    std::map<uint256, COrphanTx>::iterator it;
-    it = mapOrphanTransactions.lower_bound(InsecureRand256());
-    if (it == mapOrphanTransactions.end())
-        it = mapOrphanTransactions.begin();
-    return it->second.tx;
+    return mapOrphanTransactions.at(vOrphanList[InsecureRandRange(vOrphanList.size())]).tx;
 }
 
 BOOST_AUTO_TEST_CASE(DoS_mapOrphans)
@@ -341,15 +343,88 @@ BOOST_AUTO_TEST_CASE(DoS_mapOrphans)
         size_t sizeBefore = mapOrphanTransactions.size();
         EraseOrphansFor(i);
         BOOST_CHECK(mapOrphanTransactions.size() < sizeBefore);
+        BOOST_CHECK(!mapOrphanTransactionsByPeer.count(i));
+        for (const auto& p : mapOrphanTransactions) {
+            BOOST_CHECK(p.second.fromPeer != i);
+        }
     }
+    BOOST_CHECK_EQUAL(vOrphanList.size(), mapOrphanTransactions.size());
 
     // Test LimitOrphanTxSize() function:
     LimitOrphanTxSize(40);
     BOOST_CHECK(mapOrphanTransactions.size() <= 40);
     LimitOrphanTxSize(10);
     BOOST_CHECK(mapOrphanTransactions.size() <= 10);
+    BOOST_CHECK_EQUAL(vOrphanList.size(), mapOrphanTransactions.size());
+    for (size_t i = 0; i < vOrphanList.size(); i++) {
+        BOOST_CHECK_EQUAL(mapOrphanTransactions.at(vOrphanList[i]).nListPos, i);
+    }
     LimitOrphanTxSize(0);
     BOOST_CHECK(mapOrphanTransactions.empty());
 }
 
+static CTransactionRef MakeOrphanChild(const uint256& parentHash, uint32_t n)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(parentHash, n);
+    tx.vin[0].scriptSig << OP_1;
+    tx.vout.resize(1);
+    tx.vout[0].nValue = 1*CENT;
+    tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    return MakeTransactionRef(tx);
+}
+
+BOOST_AUTO_TEST_CASE(DoS_orphanWorkSetISLocked)
+{
+    CMutableTransaction parent1, parent2;
+    parent1.vout.resize(2);
+    parent2.vout.resize(2);
+    parent1.vout[0].nValue = parent1.vout[1].nValue = 1;
+    parent2.vout[0].nValue = parent2.vout[1].nValue = 2;
+
+    // the children of parent1 are regular orphans, the first child of parent2 was IS-locked when it was received
+    auto child1a = MakeOrphanChild(parent1.GetHash(), 0);
+    auto child1b = MakeOrphanChild(parent1.GetHash(), 1);
+    auto child2a = MakeOrphanChild(parent2.GetHash(), 0);
+    auto child2b = MakeOrphanChild(parent2.GetHash(), 1);
+    for (const auto& tx : {child1a, child1b, child2a, child2b}) {
+        BOOST_CHECK(AddOrphanTx(tx, 0));
+    }
+    mapOrphanTransactions.at(child2a->GetHash()).fISLocked = true;
+
+    COrphanWorkSet workSet;
+    AddOrphanChildrenToWorkSet(parent1, workSet, false);
+    BOOST_CHECK_EQUAL(workSet.other.size(), 2U);
+    BOOST_CHECK(workSet.locked.empty());
+
+    AddOrphanChildrenToWorkSet(parent2, workSet, false);
+    BOOST_CHECK_EQUAL(workSet.size(), 4U);
+    BOOST_CHECK(workSet.locked.count(child2a->GetHash()));
+    BOOST_CHECK(!mapOrphanTransactions.at(child2b->GetHash()).fISLocked);
+
+    // parent1 got IS-locked in the meantime, its children are moved to the locked set and flagged
+    AddOrphanChildrenToWorkSet(parent1, workSet, true);
+    BOOST_CHECK_EQUAL(workSet.size(), 4U);
+    BOOST_CHECK_EQUAL(workSet.locked.size(), 3U);
+    BOOST_CHECK(mapOrphanTransactions.at(child1a->GetHash()).fISLocked);
+    BOOST_CHECK(mapOrphanTransactions.at(child1b->GetHash()).fISLocked);
+
+    // a locked orphan is never moved back to the regular set
+    AddOrphanChildrenToWorkSet(parent2, workSet, false);
+    BOOST_CHECK_EQUAL(workSet.locked.size(), 3U);
+
+    // all locked orphans are picked before the regular one
+    std::set<uint256> picked;
+    for (int i = 0; i < 3; i++) {
+        picked.insert(workSet.pop());
+    }
+    BOOST_CHECK(picked == std::set<uint256>({child1a->GetHash(), child1b->GetHash(), child2a->GetHash()}));
+    BOOST_CHECK(workSet.pop() == child2b->GetHash());
+    BOOST_CHECK(workSet.empty());
+
+    EraseOrphansFor(0);
+    BOOST_CHECK(mapOrphanTransactions.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
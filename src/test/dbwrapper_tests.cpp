@@ -40,6 +40,35 @@ BOOST_AUTO_TEST_CASE(dbwrapper)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_tuning)
+{
+    CDBTuningOptions tuning;
+    gArgs.ForceSetArg("-testdbbloombits", "0");
+    gArgs.ForceSetArg("-testdbblocksize", "100");
+    gArgs.ForceSetArg("-testdbcompression", "1");
+    tuning.ApplyArgs("testdb");
+    BOOST_CHECK_EQUAL(tuning.nBloomBits, 0);
+    BOOST_CHECK_EQUAL(tuning.nBlockSize, 1024U); // clamped
+    BOOST_CHECK(tuning.fCompression);
+
+    // databases without bloom filter and with compression must behave the same
+    fs::path ph = fs::temp_directory_path() / fs::unique_path();
+    CDBWrapper dbw(ph, (1 << 20), true, false, false, tuning);
+    for (int i = 0; i < 1000; i++) {
+        BOOST_CHECK(dbw.Write(i, uint256S(strprintf("%x", i))));
+    }
+    for (int i = 0; i < 1000; i++) {
+        uint256 res;
+        BOOST_CHECK(dbw.Read(i, res));
+        BOOST_CHECK(res == uint256S(strprintf("%x", i)));
+    }
+    BOOST_CHECK(!dbw.Exists(1000));
+
+    gArgs.ForceRemoveArg("-testdbbloombits");
+    gArgs.ForceRemoveArg("-testdbblocksize");
+    gArgs.ForceRemoveArg("-testdbcompression");
+}
+
 // Test batch operations
 BOOST_AUTO_TEST_CASE(dbwrapper_batch)
 {
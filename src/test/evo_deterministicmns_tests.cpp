@@ -19,6 +19,9 @@
 #include "evo/providertx.h"
 #include "evo/deterministicmns.h"
 
+#include "governance/governance-object.h"
+#include "governance/governance-vote.h"
+
 #include <boost/test/unit_test.hpp>
 
 typedef std::map<COutPoint, std::pair<int, CAmount>> SimpleUTXOMap;
@@ -332,6 +335,20 @@ BOOST_FIXTURE_TEST_CASE(dip3_protx, TestChainDIP3Setup)
     for (size_t i = 0; i < 20; i++) {
         auto dmnExpectedPayee = deterministicMNManager->GetListAtChainTip().GetMNPayee();
 
+        // the payee queue is carried over from the previous list, it must match one that is built from scratch
+        auto tipList = deterministicMNManager->GetListAtChainTip();
+        CDataStream ds(SER_DISK, CLIENT_VERSION);
+        ds << tipList;
+        CDeterministicMNList freshList;
+        ds >> freshList;
+        auto projected = tipList.GetProjectedMNPayees(tipList.GetValidMNsCount());
+        auto freshProjected = freshList.GetProjectedMNPayees(freshList.GetValidMNsCount());
+        BOOST_ASSERT(projected.size() == freshProjected.size());
+        for (size_t j = 0; j < projected.size(); j++) {
+            BOOST_CHECK_EQUAL(projected[j]->proTxHash.ToString(), freshProjected[j]->proTxHash.ToString());
+        }
+        BOOST_CHECK_EQUAL(projected[0]->proTxHash.ToString(), dmnExpectedPayee->proTxHash.ToString());
+
         CBlock block = CreateAndProcessBlock({}, coinbaseKey);
         deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
         BOOST_ASSERT(!block.vtx.empty());
@@ -452,4 +469,102 @@ BOOST_FIXTURE_TEST_CASE(dip3_protx, TestChainDIP3Setup)
 
     const_cast<Consensus::Params&>(Params().GetConsensus()).DIP0003EnforcementHeight = DIP0003EnforcementHeightBackup;
 }
+// Checks that the vote tally of a governance object matches a full recount of the current votes
+static void CheckVoteTally(const CGovernanceObject& govobj, const std::vector<COutPoint>& collaterals)
+{
+    std::map<std::pair<int, int>, int> recount;
+    for (const auto& collateral : collaterals) {
+        vote_rec_t voteRecord;
+        if (!govobj.GetCurrentMNVotes(collateral, voteRecord)) {
+            continue;
+        }
+        for (const auto& p : voteRecord.mapInstances) {
+            recount[std::make_pair(p.first, (int)p.second.eOutcome)]++;
+        }
+    }
+    for (int signal = VOTE_SIGNAL_FUNDING; signal <= VOTE_SIGNAL_ENDORSED; signal++) {
+        for (int outcome = VOTE_OUTCOME_YES; outcome <= VOTE_OUTCOME_ABSTAIN; outcome++) {
+            BOOST_CHECK_EQUAL(govobj.CountMatchingVotes((vote_signal_enum_t)signal, (vote_outcome_enum_t)outcome),
+                              recount[std::make_pair(signal, outcome)]);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(dip3_governance_vote_tally, TestChainDIP3Setup)
+{
+    auto utxos = BuildSimpleUtxoMap(coinbaseTxns);
+    auto scriptCoinbase = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+
+    // the collaterals are paid to the coinbase key, so that they can be spent later
+    std::vector<uint256> dmnHashes;
+    std::vector<COutPoint> collaterals;
+    std::vector<CKey> ownerKeys;
+    std::vector<CBLSSecretKey> operatorKeys;
+    for (int i = 0; i < 4; i++) {
+        CKey ownerKey;
+        CBLSSecretKey operatorKey;
+        auto tx = CreateProRegTx(utxos, i + 1, scriptCoinbase, coinbaseKey, ownerKey, operatorKey);
+        dmnHashes.emplace_back(tx.GetHash());
+        collaterals.emplace_back(tx.GetHash(), 0);
+        ownerKeys.emplace_back(ownerKey);
+        operatorKeys.emplace_back(operatorKey);
+        CreateAndProcessBlock({tx}, coinbaseKey);
+        deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+        BOOST_ASSERT(deterministicMNManager->GetListAtChainTip().HasMN(tx.GetHash()));
+    }
+
+    int64_t nTime = GetAdjustedTime();
+    SetMockTime(nTime);
+
+    CGovernanceObject govobj(uint256(), 1, nTime, uint256(), "");
+    auto processVote = [&](int i, vote_signal_enum_t signal, vote_outcome_enum_t outcome) {
+        CGovernanceVote vote(collaterals[i], govobj.GetHash(), signal, outcome);
+        BOOST_ASSERT(vote.Sign(operatorKeys[i]));
+        CGovernanceException exception;
+        return govobj.ProcessVote(nullptr, vote, exception, *g_connman);
+    };
+
+    // added
+    for (int i = 0; i < 4; i++) {
+        BOOST_CHECK(processVote(i, VOTE_SIGNAL_FUNDING, i % 2 ? VOTE_OUTCOME_NO : VOTE_OUTCOME_YES));
+        BOOST_CHECK(processVote(i, VOTE_SIGNAL_DELETE, VOTE_OUTCOME_ABSTAIN));
+    }
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_FUNDING), 2);
+    BOOST_CHECK_EQUAL(govobj.GetNoCount(VOTE_SIGNAL_FUNDING), 2);
+    CheckVoteTally(govobj, collaterals);
+
+    // changed, later votes of the same MN replace the earlier ones (after GOVERNANCE_UPDATE_MIN)
+    SetMockTime(nTime + GOVERNANCE_UPDATE_MIN + 1);
+    BOOST_CHECK(processVote(1, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES));
+    BOOST_CHECK(processVote(2, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_ABSTAIN));
+    BOOST_CHECK(processVote(3, VOTE_SIGNAL_DELETE, VOTE_OUTCOME_NO));
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_FUNDING), 2);
+    BOOST_CHECK_EQUAL(govobj.GetNoCount(VOTE_SIGNAL_FUNDING), 1);
+    CheckVoteTally(govobj, collaterals);
+
+    // cleared, spending the collateral removes MN 0 from the list and its votes from the object
+    CMutableTransaction txSpend;
+    txSpend.vin.emplace_back(collaterals[0]);
+    txSpend.vout.emplace_back(999 * COIN, GenerateRandomAddress());
+    SignTransaction(txSpend, coinbaseKey);
+    CreateAndProcessBlock({txSpend}, coinbaseKey);
+    deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    BOOST_ASSERT(!deterministicMNManager->GetListAtChainTip().HasMN(dmnHashes[0]));
+    govobj.ClearMasternodeVotes();
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_FUNDING), 1);
+    CheckVoteTally(govobj, collaterals);
+
+    // invalidated, changing the operator key of MN 1 makes its (BLS signed) votes invalid
+    CBLSSecretKey newOperatorKey;
+    newOperatorKey.MakeNewKey();
+    auto txUpReg = CreateProUpRegTx(utxos, dmnHashes[1], ownerKeys[1], newOperatorKey.GetPublicKey(), ownerKeys[1].GetPubKey().GetID(), scriptCoinbase, coinbaseKey);
+    CreateAndProcessBlock({txUpReg}, coinbaseKey);
+    deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    BOOST_CHECK_EQUAL(govobj.RemoveInvalidVotes(collaterals[1]).size(), 2U);
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_FUNDING), 0);
+    CheckVoteTally(govobj, collaterals);
+
+    SetMockTime(0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
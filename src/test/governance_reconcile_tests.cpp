@@ -0,0 +1,75 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "governance/governance-reconcile.h"
+#include "random.h"
+#include "streams.h"
+#include "version.h"
+
+#include "test/test_dash.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(governance_reconcile_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(bucket_bits)
+{
+    BOOST_CHECK_EQUAL(CGovernanceReconSketch::CalcBucketBits(0), 0);
+    BOOST_CHECK_EQUAL(CGovernanceReconSketch::CalcBucketBits(CGovernanceReconSketch::ITEMS_PER_BUCKET), 0);
+    BOOST_CHECK_EQUAL(CGovernanceReconSketch::CalcBucketBits(CGovernanceReconSketch::ITEMS_PER_BUCKET + 1), 1);
+    BOOST_CHECK_EQUAL(CGovernanceReconSketch::CalcBucketBits(1000000), CGovernanceReconSketch::MAX_BUCKET_BITS);
+}
+
+BOOST_AUTO_TEST_CASE(differing_buckets)
+{
+    std::vector<uint256> vecHashes;
+    for (int i = 0; i < 100; i++) {
+        vecHashes.emplace_back(GetRandHash());
+    }
+
+    uint8_t nBits = CGovernanceReconSketch::CalcBucketBits(vecHashes.size());
+    CGovernanceReconSketch sketch1(nBits), sketch2(nBits);
+    for (const auto& nHash : vecHashes) {
+        sketch1.Insert(nHash);
+        sketch2.Insert(nHash);
+    }
+
+    // same sets, nothing differs
+    for (bool b : sketch1.GetDifferingBuckets(sketch2)) {
+        BOOST_CHECK(!b);
+    }
+
+    // only the bucket of the missing item differs
+    uint256 nExtra = GetRandHash();
+    sketch1.Insert(nExtra);
+    auto vecDiffering = sketch1.GetDifferingBuckets(sketch2);
+    for (size_t i = 0; i < vecDiffering.size(); i++) {
+        BOOST_CHECK_EQUAL(vecDiffering[i], i == sketch1.GetBucket(nExtra));
+    }
+
+    // roundtrip
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << sketch1;
+    CGovernanceReconSketch sketch3;
+    ss >> sketch3;
+    BOOST_CHECK(sketch3.IsValid());
+    BOOST_CHECK_EQUAL(sketch3.GetBucketBits(), nBits);
+    for (bool b : sketch1.GetDifferingBuckets(sketch3)) {
+        BOOST_CHECK(!b);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(invalid_sketch)
+{
+    // number of checksums doesn't match the number of bucket bits
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << (uint8_t)3 << std::vector<uint64_t>(4);
+    CGovernanceReconSketch sketch;
+    ss >> sketch;
+    BOOST_CHECK(!sketch.IsValid());
+
+    BOOST_CHECK(!CGovernanceReconSketch(CGovernanceReconSketch::MAX_BUCKET_BITS + 1).IsValid());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "governance/governance.h"
+#include "random.h"
+
+#include "test/test_dash.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(governance_votes_tests, BasicTestingSetup)
+
+struct TestVoter {
+    COutPoint collateral;
+    CKey votingKey;
+    CBLSSecretKey operatorKey;
+};
+
+static std::vector<TestVoter> CreateVoters(size_t count)
+{
+    std::vector<TestVoter> voters(count);
+    for (size_t i = 0; i < count; i++) {
+        voters[i].collateral = COutPoint(GetRandHash(), 0);
+        voters[i].votingKey.MakeNewKey(true);
+        voters[i].operatorKey.MakeNewKey();
+    }
+    return voters;
+}
+
+BOOST_AUTO_TEST_CASE(verify_vote_signatures_batch)
+{
+    const uint256 nParentHash = GetRandHash();
+    auto voters = CreateVoters(20);
+
+    CKey wrongVotingKey;
+    wrongVotingKey.MakeNewKey(true);
+    CBLSSecretKey wrongOperatorKey;
+    wrongOperatorKey.MakeNewKey();
+
+    // votes are kept alive here, the sig checks only point to them
+    std::vector<CGovernanceVote> votes;
+    votes.reserve(voters.size());
+    std::vector<NodeId> nodeIds;
+    std::set<uint256> invalidVotes;
+
+    // Even voters vote with their voting key (ECDSA), odd ones with their operator key (BLS). Every 5th vote is
+    // signed with a wrong key and votes are spread over 3 peers, so that each peer sends valid and invalid votes
+    // of both types
+    for (size_t i = 0; i < voters.size(); i++) {
+        bool fUseVotingKey = (i % 2) == 0;
+        bool fInvalid = (i % 5) == 0;
+        CGovernanceVote vote(voters[i].collateral, nParentHash, fUseVotingKey ? VOTE_SIGNAL_FUNDING : VOTE_SIGNAL_DELETE, VOTE_OUTCOME_YES);
+        if (fUseVotingKey) {
+            const CKey& key = fInvalid ? wrongVotingKey : voters[i].votingKey;
+            BOOST_CHECK(vote.Sign(key, key.GetPubKey().GetID()));
+        } else {
+            BOOST_CHECK(vote.Sign(fInvalid ? wrongOperatorKey : voters[i].operatorKey));
+        }
+        votes.emplace_back(vote);
+        nodeIds.emplace_back(i % 3);
+        if (fInvalid) {
+            invalidVotes.emplace(vote.GetHash());
+        }
+    }
+    BOOST_CHECK_EQUAL(invalidVotes.size(), 4U);
+
+    std::unordered_map<uint256, CGovernanceVoteSigCheckItem, StaticSaltedHasher> sigChecks;
+    for (size_t i = 0; i < votes.size(); i++) {
+        bool fUseVotingKey = (i % 2) == 0;
+        sigChecks.emplace(votes[i].GetHash(), CGovernanceVoteSigCheckItem{nodeIds[i], &votes[i], fUseVotingKey,
+            voters[i].votingKey.GetPubKey().GetID(), voters[i].operatorKey.GetPublicKey()});
+    }
+    BOOST_CHECK_EQUAL(sigChecks.size(), votes.size());
+
+    VerifyVoteSignatures(sigChecks);
+
+    // only the wrongly signed votes are invalid, the rest of the batch (including votes from the same peers) is valid
+    std::map<NodeId, int> mapInvalidByNode;
+    for (const auto& p : sigChecks) {
+        BOOST_CHECK_EQUAL(p.second.fValid, !invalidVotes.count(p.first));
+        if (!p.second.fValid) {
+            mapInvalidByNode[p.second.nodeId]++;
+        }
+    }
+
+    // votes 0, 5, 10 and 15 were sent by peers 0, 2, 1 and 0
+    BOOST_CHECK_EQUAL(mapInvalidByNode.size(), 3U);
+    BOOST_CHECK_EQUAL(mapInvalidByNode[0], 2);
+    BOOST_CHECK_EQUAL(mapInvalidByNode[1], 1);
+    BOOST_CHECK_EQUAL(mapInvalidByNode[2], 1);
+}
+
+BOOST_AUTO_TEST_CASE(verify_vote_signatures_shifted)
+{
+    auto voters = CreateVoters(2);
+
+    CGovernanceVote vote1(voters[0].collateral, GetRandHash(), VOTE_SIGNAL_DELETE, VOTE_OUTCOME_YES);
+    CGovernanceVote vote2(voters[1].collateral, GetRandHash(), VOTE_SIGNAL_DELETE, VOTE_OUTCOME_NO);
+    BOOST_CHECK(vote1.Sign(voters[0].operatorKey));
+    BOOST_CHECK(vote2.Sign(voters[1].operatorKey));
+
+    // The vote hash doesn't cover the signature, so adding the same delta to one signature and subtracting it from
+    // the other one keeps the hashes and the aggregated signature the same. Only secure verification detects this
+    CBLSSecretKey deltaKey;
+    deltaKey.MakeNewKey();
+    CBLSSignature delta = deltaKey.Sign(GetRandHash());
+    CBLSSignature sig1, sig2;
+    sig1.SetBuf(vote1.GetSignature());
+    sig2.SetBuf(vote2.GetSignature());
+    sig1.AggregateInsecure(delta);
+    sig2.SubInsecure(delta);
+    std::vector<unsigned char> vchSig1, vchSig2;
+    sig1.GetBuf(vchSig1);
+    sig2.GetBuf(vchSig2);
+    vote1.SetSignature(vchSig1);
+    vote2.SetSignature(vchSig2);
+
+    std::unordered_map<uint256, CGovernanceVoteSigCheckItem, StaticSaltedHasher> sigChecks;
+    sigChecks.emplace(vote1.GetHash(), CGovernanceVoteSigCheckItem{0, &vote1, false, CKeyID(), voters[0].operatorKey.GetPublicKey()});
+    sigChecks.emplace(vote2.GetHash(), CGovernanceVoteSigCheckItem{0, &vote2, false, CKeyID(), voters[1].operatorKey.GetPublicKey()});
+
+    VerifyVoteSignatures(sigChecks);
+
+    for (const auto& p : sigChecks) {
+        BOOST_CHECK(!p.second.fValid);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(verify_vote_signatures_malformed)
+{
+    auto voters = CreateVoters(2);
+
+    // a BLS vote of a masternode without a valid operator key and an ECDSA vote without a signature
+    CGovernanceVote voteBLS(voters[0].collateral, GetRandHash(), VOTE_SIGNAL_DELETE, VOTE_OUTCOME_YES);
+    CGovernanceVote voteECDSA(voters[1].collateral, GetRandHash(), VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_NO);
+    BOOST_CHECK(voteBLS.Sign(voters[0].operatorKey));
+
+    std::unordered_map<uint256, CGovernanceVoteSigCheckItem, StaticSaltedHasher> sigChecks;
+    sigChecks.emplace(voteBLS.GetHash(), CGovernanceVoteSigCheckItem{0, &voteBLS, false, CKeyID(), CBLSPublicKey()});
+    sigChecks.emplace(voteECDSA.GetHash(), CGovernanceVoteSigCheckItem{1, &voteECDSA, true, voters[1].votingKey.GetPubKey().GetID(), CBLSPublicKey()});
+
+    VerifyVoteSignatures(sigChecks);
+
+    for (const auto& p : sigChecks) {
+        BOOST_CHECK(!p.second.fValid);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
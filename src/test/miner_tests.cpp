@@ -11,14 +11,21 @@
 #include "validation.h"
 #include "masternode/masternode-payments.h"
 #include "miner.h"
+#include "netbase.h"
+#include "keystore.h"
 #include "policy/policy.h"
 #include "pubkey.h"
+#include "script/sign.h"
 #include "script/standard.h"
 #include "txmempool.h"
 #include "uint256.h"
 #include "util.h"
 #include "utilstrencodings.h"
 
+#include "evo/deterministicmns.h"
+#include "evo/providertx.h"
+#include "evo/specialtx.h"
+
 #include "test/test_dash.h"
 
 #include <memory>
@@ -531,4 +538,148 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+static CMutableTransaction CreateSpendTx(const CTransaction& txFrom, uint32_t n, CAmount nFee, const CKey& key, const CScript& scriptPubKey)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint(txFrom.GetHash(), n));
+    tx.vout.emplace_back(txFrom.vout[n].nValue - nFee, scriptPubKey);
+
+    CBasicKeyStore keystore;
+    keystore.AddKey(key);
+    BOOST_CHECK(SignSignature(keystore, txFrom, tx, 0, SIGHASH_ALL));
+    return tx;
+}
+
+static bool ToMemPool(const CMutableTransaction& tx)
+{
+    LOCK(cs_main);
+    CValidationState state;
+    return AcceptToMemoryPool(mempool, state, MakeTransactionRef(tx), false, nullptr, true, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(CreateNewBlock_cache, TestChainDIP3Setup)
+{
+    const CChainParams& chainparams = Params();
+    CScript scriptPubKey = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+
+    std::vector<CMutableTransaction> txs;
+    for (size_t i = 0; i < 3; i++) {
+        txs.emplace_back(CreateSpendTx(coinbaseTxns[i], 0, 10000 * (i + 1), coinbaseKey, scriptPubKey));
+        BOOST_CHECK(ToMemPool(txs.back()));
+    }
+
+    // the first template on a new tip can't reuse anything
+    BlockAssembler assembler = AssemblerForTest(chainparams);
+    auto pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 4U);
+    BOOST_CHECK_EQUAL(assembler.GetCachedTxCount(), 0);
+    BOOST_CHECK(!assembler.AreCbTxRootsCached());
+
+    // cache hit on an unchanged mempool, the result is the same as before
+    auto pblocktemplate2 = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(assembler.GetCachedTxCount(), 3);
+    BOOST_CHECK(assembler.AreCbTxRootsCached());
+    BOOST_CHECK_EQUAL(pblocktemplate2->block.vtx.size(), pblocktemplate->block.vtx.size());
+    for (size_t i = 1; i < pblocktemplate->block.vtx.size(); i++) {
+        BOOST_CHECK(pblocktemplate2->block.vtx[i]->GetHash() == pblocktemplate->block.vtx[i]->GetHash());
+    }
+
+    // a new tx is added on top of the reused selection
+    txs.emplace_back(CreateSpendTx(coinbaseTxns[3], 0, 50000, coinbaseKey, scriptPubKey));
+    BOOST_CHECK(ToMemPool(txs.back()));
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(assembler.GetCachedTxCount(), 3);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 5U);
+
+    // a fee change invalidates the selection
+    mempool.PrioritiseTransaction(txs[0].GetHash(), 100000);
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(assembler.GetCachedTxCount(), 0);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 5U);
+    BOOST_CHECK(pblocktemplate->block.vtx[1]->GetHash() == txs[0].GetHash());
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(assembler.GetCachedTxCount(), 4);
+
+    // so does an evicted tx
+    mempool.removeRecursive(txs[1]);
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(assembler.GetCachedTxCount(), 0);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 4U);
+    for (const auto& tx : pblocktemplate->block.vtx) {
+        BOOST_CHECK(tx->GetHash() != txs[1].GetHash());
+    }
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(assembler.GetCachedTxCount(), 3);
+    // the CbTx roots are the same for all of these, as no special txs or collaterals are involved
+    BOOST_CHECK(assembler.AreCbTxRootsCached());
+
+    // a ProRegTx always bypasses the CbTx roots cache, the collateral might be spent in the same block
+    CKey ownerKey;
+    ownerKey.MakeNewKey(true);
+    CBLSSecretKey operatorKey;
+    operatorKey.MakeNewKey();
+
+    CProRegTx proTx;
+    proTx.collateralOutpoint.n = 0;
+    proTx.addr = LookupNumeric("1.1.1.1", 1);
+    proTx.keyIDOwner = ownerKey.GetPubKey().GetID();
+    proTx.pubKeyOperator = operatorKey.GetPublicKey();
+    proTx.keyIDVoting = ownerKey.GetPubKey().GetID();
+    proTx.scriptPayout = scriptPubKey;
+
+    // the collateral is funded by 3 coinbase outputs
+    CMutableTransaction txProReg;
+    txProReg.nVersion = 3;
+    txProReg.nType = TRANSACTION_PROVIDER_REGISTER;
+    CAmount nInputs = 0;
+    for (size_t i = 4; i < 7; i++) {
+        txProReg.vin.emplace_back(COutPoint(coinbaseTxns[i].GetHash(), 0));
+        nInputs += coinbaseTxns[i].vout[0].nValue;
+    }
+    txProReg.vout.emplace_back(1000 * COIN, scriptPubKey);
+    txProReg.vout.emplace_back(nInputs - 1000 * COIN - 10000, scriptPubKey);
+    proTx.inputsHash = CalcTxInputsHash(txProReg);
+    SetTxPayload(txProReg, proTx);
+    {
+        CBasicKeyStore keystore;
+        keystore.AddKey(coinbaseKey);
+        for (size_t i = 0; i < txProReg.vin.size(); i++) {
+            BOOST_CHECK(SignSignature(keystore, coinbaseTxns[4 + i], txProReg, i, SIGHASH_ALL));
+        }
+    }
+    BOOST_CHECK(ToMemPool(txProReg));
+
+    for (int i = 0; i < 2; i++) {
+        pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+        BOOST_CHECK(!assembler.AreCbTxRootsCached());
+        BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 5U);
+    }
+
+    // mine the ProRegTx and the other txs
+    std::vector<CMutableTransaction> blockTxs;
+    for (size_t i = 1; i < pblocktemplate->block.vtx.size(); i++) {
+        blockTxs.emplace_back(*pblocktemplate->block.vtx[i]);
+    }
+    CreateAndProcessBlock(blockTxs, coinbaseKey);
+    deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    BOOST_CHECK(deterministicMNManager->GetListAtChainTip().HasMN(txProReg.GetHash()));
+    BOOST_CHECK_EQUAL(mempool.size(), 0U);
+
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK(assembler.AreCbTxRootsCached());
+
+    // spending the collateral changes the MN list, so the roots are calculated again. TestBlockValidity would throw if
+    // outdated roots were used
+    auto txSpendCollateral = CreateSpendTx(txProReg, 0, 10000, coinbaseKey, scriptPubKey);
+    BOOST_CHECK(ToMemPool(txSpendCollateral));
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 2U);
+    BOOST_CHECK(!assembler.AreCbTxRootsCached());
+    pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+    BOOST_CHECK(assembler.AreCbTxRootsCached());
+
+    mempool.clear();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
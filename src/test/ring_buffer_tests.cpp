@@ -0,0 +1,79 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "ring_buffer.h"
+
+#include "test/test_dash.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(ring_buffer_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(ring_buffer_test)
+{
+    mpsc_ring_buffer<int> buf(3);
+    BOOST_CHECK(buf.capacity() == 4);
+
+    int v;
+    BOOST_CHECK(!buf.try_pop(v));
+
+    for (int i = 0; i < 4; i++) {
+        BOOST_CHECK(buf.try_push(int(i)));
+    }
+    // full
+    BOOST_CHECK(!buf.try_push(4));
+
+    BOOST_CHECK(buf.try_pop(v) && v == 0);
+    BOOST_CHECK(buf.try_push(4));
+
+    // wraps around and keeps the order
+    for (int i = 1; i < 5; i++) {
+        BOOST_CHECK(buf.try_pop(v) && v == i);
+    }
+    BOOST_CHECK(!buf.try_pop(v));
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_multi_producer_test)
+{
+    const int producerCount = 4;
+    const int perProducer = 10000;
+
+    mpsc_ring_buffer<int> buf(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; p++) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < perProducer; i++) {
+                while (!buf.try_push(p * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // every value must be received exactly once and the values of each producer must be in order
+    std::vector<int> lastValue(producerCount, -1);
+    int received = 0;
+    while (received < producerCount * perProducer) {
+        int v;
+        if (!buf.try_pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int p = v / perProducer;
+        BOOST_CHECK(v % perProducer == lastValue[p] + 1);
+        lastValue[p] = v % perProducer;
+        received++;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    int v;
+    BOOST_CHECK(!buf.try_pop(v));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,72 @@
+// Copyright (c) 2020 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sharded_map.h"
+
+#include "test/test_dash.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(sharded_map_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(sharded_map_test)
+{
+    sharded_map<int, int, std::hash<int>, 4> map;
+
+    BOOST_CHECK(map.size() == 0);
+
+    for (int i = 0; i < 100; i++) {
+        BOOST_CHECK(map.emplace(i, i * 2));
+    }
+    BOOST_CHECK(map.size() == 100);
+
+    // emplace does not overwrite existing entries
+    BOOST_CHECK(!map.emplace(1, 5));
+    int v;
+    BOOST_CHECK(map.get(1, v) && v == 2);
+
+    map.insert_or_assign(1, 5);
+    BOOST_CHECK(map.get(1, v) && v == 5);
+
+    BOOST_CHECK(!map.get(100, v));
+    BOOST_CHECK(!map.exists(100));
+    BOOST_CHECK(map.exists(99));
+
+    // update only creates entries when asked to
+    BOOST_CHECK(!map.update(100, [](int& x) { x = 1; }));
+    BOOST_CHECK(!map.exists(100));
+    BOOST_CHECK(map.update(100, [](int& x) { x += 1; }, true));
+    BOOST_CHECK(map.get(100, v) && v == 1);
+
+    BOOST_CHECK(map.erase(100));
+    BOOST_CHECK(!map.erase(100));
+
+    v = 0;
+    BOOST_CHECK(map.visit(2, [&](const int& x) { v = x; }) && v == 4);
+    BOOST_CHECK(!map.visit(100, [&](const int& x) { v = x; }));
+
+    // update_erase_if only erases when the callback returns true
+    BOOST_CHECK(map.update_erase_if(2, [](int& x) { x = 3; return false; }));
+    BOOST_CHECK(map.get(2, v) && v == 3);
+    BOOST_CHECK(map.update_erase_if(2, [](int& x) { x = 4; return true; }));
+    BOOST_CHECK(!map.exists(2));
+    BOOST_CHECK(!map.update_erase_if(2, [](int&) { return true; }));
+    BOOST_CHECK(map.emplace(2, 4));
+
+    // erase all odd keys
+    BOOST_CHECK(map.erase_if([](int k, int&) { return k % 2 != 0; }) == 50);
+    BOOST_CHECK(map.size() == 50);
+
+    auto snapshot = map.snapshot();
+    BOOST_CHECK(snapshot.size() == 50);
+    for (auto& p : snapshot) {
+        BOOST_CHECK(p.first % 2 == 0);
+        BOOST_CHECK(p.second == p.first * 2);
+    }
+
+    map.clear();
+    BOOST_CHECK(map.size() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,7 @@ static const char DB_BLOCK_FILES = 'f';
 static const char DB_TXINDEX = 't';
 static const char DB_ADDRESSINDEX = 'a';
 static const char DB_ADDRESSUNSPENTINDEX = 'u';
+static const char DB_ADDRESSBALANCEINDEX = 'A';
 static const char DB_TIMESTAMPINDEX = 's';
 static const char DB_SPENTINDEX = 'p';
 static const char DB_BLOCK_INDEX = 'b';
@@ -33,6 +34,7 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_INDEX_BEST_BLOCK = 'I';
 
 namespace {
 
@@ -151,7 +153,10 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
-CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
+CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) :
+    CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe),
+    nMaxIndexBatchSize(gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize))
+{
 }
 
 bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
@@ -357,6 +362,284 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type,
     return true;
 }
 
+// Reads the address index entries of at most "limit" transactions, starting at the transaction at (startHeight, startTxIndex).
+// Entries of a single transaction are never split across pages. fMore is set if there are more entries (up to "end")
+bool CBlockTreeDB::ReadAddressIndexPage(uint160 addressHash, int type, int startHeight, unsigned int startTxIndex, int end, size_t limit,
+                                        std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex, bool &fMore) {
+    fMore = false;
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorTxKey(type, addressHash, startHeight, startTxIndex)));
+
+    size_t txCount = 0;
+    int lastHeight = -1;
+    unsigned int lastTxIndex = 0;
+
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressIndexKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX && key.second.type == (unsigned int)type && key.second.hashBytes == addressHash) {
+            if (end > 0 && key.second.blockHeight > end) {
+                break;
+            }
+            if (key.second.blockHeight != lastHeight || key.second.txindex != lastTxIndex) {
+                if (txCount == limit) {
+                    fMore = true;
+                    break;
+                }
+                txCount++;
+                lastHeight = key.second.blockHeight;
+                lastTxIndex = key.second.txindex;
+            }
+            CAmount nValue;
+            if (pcursor->GetValue(nValue)) {
+                addressIndex.push_back(std::make_pair(key.second, nValue));
+                pcursor->Next();
+            } else {
+                return error("failed to get address index value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Reads at most "limit" unspent outputs in DB order, starting at (startTxHash, startIndex)
+bool CBlockTreeDB::ReadAddressUnspentIndexPage(uint160 addressHash, int type, const uint256& startTxHash, size_t startIndex, size_t limit,
+                                               std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs, bool &fMore) {
+    fMore = false;
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressUnspentKey(type, addressHash, startTxHash, startIndex)));
+
+    size_t count = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressUnspentKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSUNSPENTINDEX && key.second.type == (unsigned int)type && key.second.hashBytes == addressHash) {
+            if (count == limit) {
+                fMore = true;
+                break;
+            }
+            CAddressUnspentValue nValue;
+            if (pcursor->GetValue(nValue)) {
+                unspentOutputs.push_back(std::make_pair(key.second, nValue));
+                count++;
+                pcursor->Next();
+            } else {
+                return error("failed to get address unspent value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
+namespace {
+struct AddressBalanceDelta {
+    CAmount balance{0};
+    CAmount received{0};
+    std::set<uint256> txids;
+};
+typedef std::map<std::pair<unsigned int, uint160>, AddressBalanceDelta> AddressBalanceDeltaMap;
+
+// Sums up all deltas of a block per address
+AddressBalanceDeltaMap SumAddressBalanceDeltas(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect)
+{
+    AddressBalanceDeltaMap deltas;
+    for (const auto& p : vect) {
+        auto& delta = deltas[std::make_pair(p.first.type, p.first.hashBytes)];
+        delta.balance += p.second;
+        if (p.second > 0) {
+            delta.received += p.second;
+        }
+        delta.txids.emplace(p.first.txhash);
+    }
+    return deltas;
+}
+} // namespace
+
+bool CBlockTreeDB::WriteBlockIndexes(const std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                                     const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &addressUnspentIndex,
+                                     const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > &spentIndex,
+                                     const CTimestampIndexKey* timestampIndex, int nHeight, const uint256& blockHash,
+                                     bool fAddressBalanceIndex) {
+    LOCK(cs_indexBatch);
+
+    if (!indexBatch) {
+        indexBatch.reset(new CDBBatch(*this));
+    }
+    indexBatchBestBlock = blockHash;
+
+    for (const auto& p : addressIndex) {
+        indexBatch->Write(std::make_pair(DB_ADDRESSINDEX, p.first), p.second);
+    }
+    for (const auto& p : addressUnspentIndex) {
+        if (p.second.IsNull()) {
+            indexBatch->Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, p.first));
+        } else {
+            indexBatch->Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, p.first), p.second);
+        }
+    }
+    for (const auto& p : spentIndex) {
+        if (p.second.IsNull()) {
+            indexBatch->Erase(std::make_pair(DB_SPENTINDEX, p.first));
+        } else {
+            indexBatch->Write(std::make_pair(DB_SPENTINDEX, p.first), p.second);
+        }
+    }
+    if (timestampIndex) {
+        indexBatch->Write(std::make_pair(DB_TIMESTAMPINDEX, *timestampIndex), 0);
+    }
+
+    if (fAddressBalanceIndex) {
+        // Balances are kept in pendingAddressBalances until the batch is written, so that following blocks see them
+        for (const auto& p : SumAddressBalanceDeltas(addressIndex)) {
+            const auto& delta = p.second;
+
+            auto it = pendingAddressBalances.find(p.first);
+            if (it == pendingAddressBalances.end()) {
+                it = pendingAddressBalances.emplace(p.first, CAddressBalanceValue()).first;
+                if (!Read(std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorKey(p.first.first, p.first.second)), it->second)) {
+                    it->second.SetNull();
+                }
+            }
+            auto& value = it->second;
+
+            if (value.IsNull()) {
+                value.firstHeight = nHeight;
+            }
+            value.balance += delta.balance;
+            value.received += delta.received;
+            value.txCount += delta.txids.size();
+            value.lastHeight = nHeight;
+        }
+    }
+
+    if (indexBatch->SizeEstimate() > nMaxIndexBatchSize) {
+        return FlushIndexBatch();
+    }
+    return true;
+}
+
+bool CBlockTreeDB::FlushIndexBatch() {
+    LOCK(cs_indexBatch);
+
+    if (!indexBatch) {
+        return true;
+    }
+
+    for (const auto& p : pendingAddressBalances) {
+        indexBatch->Write(std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorKey(p.first.first, p.first.second)), p.second);
+    }
+    // written together with the entries, so that no block is applied twice or only partially after a crash
+    indexBatch->Write(DB_INDEX_BEST_BLOCK, indexBatchBestBlock);
+
+    LogPrint(BCLog::COINDB, "Writing index batch of %.2f MiB\n", indexBatch->SizeEstimate() * (1.0 / 1048576.0));
+    bool ret = WriteBatch(*indexBatch);
+    indexBatch.reset();
+    pendingAddressBalances.clear();
+    return ret;
+}
+
+bool CBlockTreeDB::UndoBlockIndexes(const std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                                    const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &addressUnspentIndex,
+                                    const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > &spentIndex,
+                                    const CTimestampIndexKey* timestampIndex, int nHeight, const uint256& prevBlockHash,
+                                    bool fAddressBalanceIndex) {
+    LOCK(cs_indexBatch);
+
+    // pending entries of connected blocks must be written before we can undo them
+    if (!FlushIndexBatch()) {
+        return false;
+    }
+
+    CDBBatch batch(*this);
+    for (const auto& p : addressIndex) {
+        batch.Erase(std::make_pair(DB_ADDRESSINDEX, p.first));
+    }
+    for (const auto& p : addressUnspentIndex) {
+        if (p.second.IsNull()) {
+            batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, p.first));
+        } else {
+            batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, p.first), p.second);
+        }
+    }
+    for (const auto& p : spentIndex) {
+        if (p.second.IsNull()) {
+            batch.Erase(std::make_pair(DB_SPENTINDEX, p.first));
+        } else {
+            batch.Write(std::make_pair(DB_SPENTINDEX, p.first), p.second);
+        }
+    }
+    if (timestampIndex) {
+        batch.Erase(std::make_pair(DB_TIMESTAMPINDEX, *timestampIndex));
+    }
+
+    if (fAddressBalanceIndex) {
+        for (const auto& p : SumAddressBalanceDeltas(addressIndex)) {
+            auto dbKey = std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorKey(p.first.first, p.first.second));
+            const auto& delta = p.second;
+
+            CAddressBalanceValue value;
+            if (!Read(dbKey, value)) {
+                value.SetNull();
+            }
+
+            value.balance -= delta.balance;
+            value.received -= delta.received;
+            value.txCount -= std::min<uint32_t>(value.txCount, delta.txids.size());
+            if (value.IsNull()) {
+                batch.Erase(dbKey);
+                continue;
+            }
+            if (value.lastHeight >= nHeight) {
+                // The address index entries of the disconnected block are only erased with this batch, so the entry
+                // right before the first one at the disconnected height is the new last one
+                std::unique_ptr<CDBIterator> pcursor(NewIterator());
+                pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(p.first.first, p.first.second, nHeight)));
+                if (pcursor->Valid()) {
+                    pcursor->Prev();
+                } else {
+                    pcursor->SeekToLast();
+                }
+                std::pair<char, CAddressIndexKey> key;
+                if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX &&
+                    key.second.type == p.first.first && key.second.hashBytes == p.first.second) {
+                    value.lastHeight = key.second.blockHeight;
+                } else {
+                    return error("failed to find last address index entry");
+                }
+            }
+            batch.Write(dbKey, value);
+        }
+    }
+
+    batch.Write(DB_INDEX_BEST_BLOCK, prevBlockHash);
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::ReadIndexBestBlock(uint256 &hash) {
+    return Read(DB_INDEX_BEST_BLOCK, hash);
+}
+
+bool CBlockTreeDB::WriteIndexBestBlock(const uint256 &hash) {
+    return Write(DB_INDEX_BEST_BLOCK, hash);
+}
+
+bool CBlockTreeDB::ReadAddressBalanceIndex(uint160 addressHash, int type, CAddressBalanceValue &value) {
+    if (!Read(std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorKey(type, addressHash)), value)) {
+        value.SetNull();
+    }
+    return true;
+}
+
 bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
     CDBBatch batch(*this);
     batch.Write(std::make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
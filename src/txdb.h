@@ -10,6 +10,7 @@
 #include "dbwrapper.h"
 #include "chain.h"
 #include "spentindex.h"
+#include "sync.h"
 
 #include <map>
 #include <string>
@@ -115,6 +116,16 @@ public:
 private:
     CBlockTreeDB(const CBlockTreeDB&);
     void operator=(const CBlockTreeDB&);
+
+    // Address, spent and timestamp index writes of connected blocks which are not written yet, see WriteBlockIndexes()
+    // The batch is written once it grows larger than nMaxIndexBatchSize (-dbbatchsize)
+    const size_t nMaxIndexBatchSize;
+    CCriticalSection cs_indexBatch;
+    std::unique_ptr<CDBBatch> indexBatch;
+    std::map<std::pair<unsigned int, uint160>, CAddressBalanceValue> pendingAddressBalances;
+    // The last block whose entries are in indexBatch
+    uint256 indexBatchBestBlock;
+
 public:
     bool WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo);
     bool ReadBlockFileInfo(int nFile, CBlockFileInfo &fileinfo);
@@ -134,6 +145,34 @@ public:
     bool ReadAddressIndex(uint160 addressHash, int type,
                           std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                           int start = 0, int end = 0);
+    bool ReadAddressIndexPage(uint160 addressHash, int type, int startHeight, unsigned int startTxIndex, int end, size_t limit,
+                              std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex, bool &fMore);
+    bool ReadAddressUnspentIndexPage(uint160 addressHash, int type, const uint256& startTxHash, size_t startIndex, size_t limit,
+                                     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs, bool &fMore);
+    /**
+     * Adds the address, spent and timestamp index entries of a connected block to the pending index batch. The batch
+     * is only written when it gets too large or when FlushIndexBatch() is called, so that the entries of many blocks
+     * are written at once while syncing. Entries are not visible to the Read* methods before they are written.
+     * blockHash is written as the last indexed block together with the batch.
+     */
+    bool WriteBlockIndexes(const std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                           const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &addressUnspentIndex,
+                           const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > &spentIndex,
+                           const CTimestampIndexKey* timestampIndex, int nHeight, const uint256& blockHash,
+                           bool fAddressBalanceIndex);
+    bool FlushIndexBatch();
+    /**
+     * Writes all pending entries and then undoes the entries of a disconnected block, which makes prevBlockHash the
+     * last indexed block. The entries must be in the order in which they are undone.
+     */
+    bool UndoBlockIndexes(const std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                          const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &addressUnspentIndex,
+                          const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > &spentIndex,
+                          const CTimestampIndexKey* timestampIndex, int nHeight, const uint256& prevBlockHash,
+                          bool fAddressBalanceIndex);
+    bool ReadIndexBestBlock(uint256 &hash);
+    bool WriteIndexBestBlock(const uint256 &hash);
+    bool ReadAddressBalanceIndex(uint160 addressHash, int type, CAddressBalanceValue &value);
     bool WriteTimestampIndex(const CTimestampIndexKey &timestampIndex);
     bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &vect);
     bool WriteFlag(const std::string &name, bool fValue);
@@ -22,6 +22,7 @@
 #include "primitives/transaction.h"
 #include "sync.h"
 #include "random.h"
+#include "sharded_map.h"
 #include "netaddress.h"
 #include "bls/bls.h"
 #include "pubkey.h"
@@ -496,17 +497,16 @@ private:
     typedef std::map<txiter, TxLinks, CompareIteratorByHash> txlinksMap;
     txlinksMap mapLinks;
 
+    // The address and spent indexes are not guarded by cs but by the locks of their shards, so that adding entries
+    // and reading them from RPCs doesn't contend on the mempool lock
     typedef std::map<CMempoolAddressDeltaKey, CMempoolAddressDelta, CMempoolAddressDeltaKeyCompare> addressDeltaMap;
-    addressDeltaMap mapAddress;
+    sharded_map<std::pair<int, uint160>, addressDeltaMap, CMempoolAddressHasher> mapAddress; // (type, addressBytes) -> deltas of the address
 
-    typedef std::map<uint256, std::vector<CMempoolAddressDeltaKey> > addressDeltaMapInserted;
-    addressDeltaMapInserted mapAddressInserted;
+    sharded_map<uint256, std::vector<CMempoolAddressDeltaKey>, StaticSaltedHasher> mapAddressInserted;
 
-    typedef std::map<CSpentIndexKey, CSpentIndexValue, CSpentIndexKeyCompare> mapSpentIndex;
-    mapSpentIndex mapSpent;
+    sharded_map<CSpentIndexKey, CSpentIndexValue, CSpentIndexKeyHasher> mapSpent;
 
-    typedef std::map<uint256, std::vector<CSpentIndexKey> > mapSpentIndexInserted;
-    mapSpentIndexInserted mapSpentInserted;
+    sharded_map<uint256, std::vector<CSpentIndexKey>, StaticSaltedHasher> mapSpentInserted;
 
     std::multimap<uint256, uint256> mapProTxRefs; // proTxHash -> transaction (all TXs that refer to an existing proTx)
     std::map<CService, uint256> mapProTxAddresses;
@@ -15,6 +15,7 @@
 #include "ctpl.h"
 #include "fs.h"
 #include "random.h"
+#include "ring_buffer.h"
 #include "serialize.h"
 #include "stacktraces.h"
 #include "utilstrencodings.h"
@@ -92,6 +93,9 @@
 #include <openssl/rand.h>
 #include <openssl/conf.h>
 
+#include <condition_variable>
+#include <thread>
+
 // Application startup time (used for uptime calculation)
 const int64_t nStartupTime = GetTime();
 
@@ -203,6 +207,106 @@ static int FileWriteStr(const std::string &str, FILE *fp)
     return fwrite(str.data(), 1, str.size(), fp);
 }
 
+namespace {
+/**
+ * State of the asynchronous debug.log writer. LogPrintStr only pushes messages into the lock-free buffer, which is
+ * drained by a dedicated thread. If the buffer is full, messages are dropped and counted instead of blocking the
+ * logging thread. Whoever drains the buffer must hold mutexDebugLog.
+ */
+struct DebugLogWriter
+{
+    static const size_t MAX_BUFFERED_BYTES = 32 * 1024 * 1024;
+
+    mpsc_ring_buffer<std::string> buffer;
+    std::atomic<size_t> bufferedBytes{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex csWakeup;
+    std::condition_variable cvWakeup;
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stop{false};
+    std::thread thread;
+
+    explicit DebugLogWriter(size_t capacity) : buffer(capacity) {}
+};
+} // namespace
+
+// Set while the writer thread is running. The writer is leaked after stopping it, as logging threads might still
+// access it
+static std::atomic<DebugLogWriter*> debugLogWriter(nullptr);
+
+static void PushDebugLog(DebugLogWriter* writer, std::string&& str)
+{
+    size_t len = str.size();
+    if (writer->bufferedBytes.fetch_add(len) + len > DebugLogWriter::MAX_BUFFERED_BYTES || !writer->buffer.try_push(std::move(str))) {
+        writer->bufferedBytes -= len;
+        writer->dropped++;
+        return;
+    }
+    if (writer->sleeping.exchange(false)) {
+        writer->cvWakeup.notify_one();
+    }
+}
+
+// Writes all buffered messages to fileout, must be called with mutexDebugLog held
+static size_t WriteBufferedDebugLog(DebugLogWriter* writer)
+{
+    std::string strBatch;
+    size_t count = 0;
+
+    uint64_t dropped = writer->dropped.exchange(0);
+    if (dropped != 0) {
+        strBatch = strprintf("%s Dropped %d log messages, the log buffer was full\n", DateTimeStrFormat("%Y-%m-%d %H:%M:%S", GetTime()), dropped);
+    }
+
+    // reopen the log file, if requested
+    if (fReopenDebugLog) {
+        fReopenDebugLog = false;
+        fs::path pathDebug = GetDataDir() / "debug.log";
+        if (fsbridge::freopen(pathDebug,"a",fileout) != nullptr)
+            setbuf(fileout, nullptr); // unbuffered
+    }
+
+    // write in batches instead of one syscall per message
+    std::string str;
+    while (writer->buffer.try_pop(str)) {
+        writer->bufferedBytes -= str.size();
+        strBatch += str;
+        count++;
+        if (strBatch.size() >= 64 * 1024) {
+            FileWriteStr(strBatch, fileout);
+            strBatch.clear();
+        }
+    }
+    if (!strBatch.empty()) {
+        FileWriteStr(strBatch, fileout);
+    }
+    return count;
+}
+
+static void DebugLogWriterThread(DebugLogWriter* writer)
+{
+    RenameThread("dash-logwriter");
+
+    while (true) {
+        size_t count;
+        {
+            boost::mutex::scoped_lock scoped_lock(*mutexDebugLog);
+            count = WriteBufferedDebugLog(writer);
+        }
+        if (count == 0) {
+            if (writer->stop) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(writer->csWakeup);
+            writer->sleeping = true;
+            // a message pushed right before we start waiting might not wake us up, hence the timeout
+            writer->cvWakeup.wait_for(lock, std::chrono::milliseconds(100));
+            writer->sleeping = false;
+        }
+    }
+}
+
 static void DebugPrintInit()
 {
     assert(mutexDebugLog == nullptr);
@@ -232,6 +336,50 @@ void OpenDebugLog()
     vMsgsBeforeOpenLog = nullptr;
 }
 
+void StartDebugLogWriter(size_t nBufferSize)
+{
+    boost::call_once(&DebugPrintInit, debugPrintInitFlag);
+    boost::mutex::scoped_lock scoped_lock(*mutexDebugLog);
+
+    if (fileout == nullptr || nBufferSize == 0 || debugLogWriter != nullptr) {
+        return;
+    }
+
+    DebugLogWriter* writer = new DebugLogWriter(std::min<size_t>(nBufferSize, MAX_LOGBUFFERSIZE));
+    writer->thread = std::thread(&DebugLogWriterThread, writer);
+    debugLogWriter = writer;
+}
+
+void StopDebugLogWriter()
+{
+    DebugLogWriter* writer = debugLogWriter.exchange(nullptr);
+    if (writer == nullptr) {
+        return;
+    }
+
+    writer->stop = true;
+    writer->cvWakeup.notify_one();
+    writer->thread.join();
+
+    // messages pushed by threads which didn't see the writer being stopped
+    boost::mutex::scoped_lock scoped_lock(*mutexDebugLog);
+    WriteBufferedDebugLog(writer);
+}
+
+void FlushDebugLog()
+{
+    DebugLogWriter* writer = debugLogWriter;
+    if (writer == nullptr) {
+        return;
+    }
+
+    // we might be crashing while another thread holds the lock, so don't wait for it
+    boost::unique_lock<boost::mutex> lock(*mutexDebugLog, boost::try_to_lock);
+    if (lock.owns_lock()) {
+        WriteBufferedDebugLog(writer);
+    }
+}
+
 struct CLogCategoryDesc
 {
     uint64_t flag;
@@ -433,6 +581,13 @@ int LogPrintStr(const std::string &str)
     }
     else if (fPrintToDebugLog)
     {
+        DebugLogWriter* writer = debugLogWriter;
+        if (writer != nullptr) {
+            ret = strTimestamped.length();
+            PushDebugLog(writer, std::move(strTimestamped));
+            return ret;
+        }
+
         boost::call_once(&DebugPrintInit, debugPrintInitFlag);
         boost::mutex::scoped_lock scoped_lock(*mutexDebugLog);
 
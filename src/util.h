@@ -56,6 +56,8 @@ static const bool DEFAULT_LOGTIMEMICROS  = false;
 static const bool DEFAULT_LOGIPS         = false;
 static const bool DEFAULT_LOGTIMESTAMPS  = true;
 static const bool DEFAULT_LOGTHREADNAMES = false;
+static const unsigned int DEFAULT_LOGBUFFERSIZE = 16384;
+static const unsigned int MAX_LOGBUFFERSIZE = 1 << 20;
 
 /** Signals for translation. */
 class CTranslationInterface
@@ -233,6 +235,11 @@ void CreatePidFile(const fs::path &path, pid_t pid);
 fs::path GetSpecialFolderPath(int nFolder, bool fCreate = true);
 #endif
 void OpenDebugLog();
+/** Write debug.log from a separate thread, buffering up to nBufferSize messages */
+void StartDebugLogWriter(size_t nBufferSize);
+void StopDebugLogWriter();
+/** Write all messages buffered by the debug.log writer from the calling thread (e.g. when crashing) */
+void FlushDebugLog();
 void ShrinkDebugFile();
 void runCommand(const std::string& strCommand);
 
@@ -29,7 +29,9 @@ struct MainSignalsInstance {
     boost::signals2::signal<void (const CBlockIndex *)>AcceptedBlockHeader;
     boost::signals2::signal<void (const CBlockIndex *, bool)>NotifyHeaderTip;
     boost::signals2::signal<void (const CTransaction &tx, const llmq::CInstantSendLock& islock)>NotifyTransactionLock;
+    boost::signals2::signal<void (const llmq::CInstantSendLock& islock)>NotifyInstantSendLock;
     boost::signals2::signal<void (const CBlockIndex* pindex, const llmq::CChainLockSig& clsig)>NotifyChainLock;
+    boost::signals2::signal<void (const llmq::CRecoveredSig& recoveredSig)>NotifyRecoveredSig;
     boost::signals2::signal<void (const CGovernanceVote &vote)>NotifyGovernanceVote;
     boost::signals2::signal<void (const CGovernanceObject &object)>NotifyGovernanceObject;
     boost::signals2::signal<void (const CTransaction &currentTx, const CTransaction &previousTx)>NotifyInstantSendDoubleSpendAttempt;
@@ -70,7 +72,9 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.m_internals->BlockConnected.connect(boost::bind(&CValidationInterface::BlockConnected, pwalletIn, _1, _2, _3));
     g_signals.m_internals->BlockDisconnected.connect(boost::bind(&CValidationInterface::BlockDisconnected, pwalletIn, _1, _2));
     g_signals.m_internals->NotifyTransactionLock.connect(boost::bind(&CValidationInterface::NotifyTransactionLock, pwalletIn, _1, _2));
+    g_signals.m_internals->NotifyInstantSendLock.connect(boost::bind(&CValidationInterface::NotifyInstantSendLock, pwalletIn, _1));
     g_signals.m_internals->NotifyChainLock.connect(boost::bind(&CValidationInterface::NotifyChainLock, pwalletIn, _1, _2));
+    g_signals.m_internals->NotifyRecoveredSig.connect(boost::bind(&CValidationInterface::NotifyRecoveredSig, pwalletIn, _1));
     g_signals.m_internals->SetBestChain.connect(boost::bind(&CValidationInterface::SetBestChain, pwalletIn, _1));
     g_signals.m_internals->Inventory.connect(boost::bind(&CValidationInterface::Inventory, pwalletIn, _1));
     g_signals.m_internals->Broadcast.connect(boost::bind(&CValidationInterface::ResendWalletTransactions, pwalletIn, _1, _2));
@@ -87,7 +91,9 @@ void UnregisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.m_internals->Broadcast.disconnect(boost::bind(&CValidationInterface::ResendWalletTransactions, pwalletIn, _1, _2));
     g_signals.m_internals->Inventory.disconnect(boost::bind(&CValidationInterface::Inventory, pwalletIn, _1));
     g_signals.m_internals->SetBestChain.disconnect(boost::bind(&CValidationInterface::SetBestChain, pwalletIn, _1));
+    g_signals.m_internals->NotifyRecoveredSig.disconnect(boost::bind(&CValidationInterface::NotifyRecoveredSig, pwalletIn, _1));
     g_signals.m_internals->NotifyChainLock.disconnect(boost::bind(&CValidationInterface::NotifyChainLock, pwalletIn, _1, _2));
+    g_signals.m_internals->NotifyInstantSendLock.disconnect(boost::bind(&CValidationInterface::NotifyInstantSendLock, pwalletIn, _1));
     g_signals.m_internals->NotifyTransactionLock.disconnect(boost::bind(&CValidationInterface::NotifyTransactionLock, pwalletIn, _1, _2));
     g_signals.m_internals->TransactionAddedToMempool.disconnect(boost::bind(&CValidationInterface::TransactionAddedToMempool, pwalletIn, _1, _2));
     g_signals.m_internals->BlockConnected.disconnect(boost::bind(&CValidationInterface::BlockConnected, pwalletIn, _1, _2, _3));
@@ -108,7 +114,9 @@ void UnregisterAllValidationInterfaces() {
     g_signals.m_internals->Inventory.disconnect_all_slots();
     g_signals.m_internals->SetBestChain.disconnect_all_slots();
     g_signals.m_internals->NotifyTransactionLock.disconnect_all_slots();
+    g_signals.m_internals->NotifyInstantSendLock.disconnect_all_slots();
     g_signals.m_internals->NotifyChainLock.disconnect_all_slots();
+    g_signals.m_internals->NotifyRecoveredSig.disconnect_all_slots();
     g_signals.m_internals->TransactionAddedToMempool.disconnect_all_slots();
     g_signals.m_internals->BlockConnected.disconnect_all_slots();
     g_signals.m_internals->BlockDisconnected.disconnect_all_slots();
@@ -170,10 +178,18 @@ void CMainSignals::NotifyTransactionLock(const CTransaction &tx, const llmq::CIn
         m_internals->NotifyTransactionLock(tx, islock);
 }
 
+void CMainSignals::NotifyInstantSendLock(const llmq::CInstantSendLock& islock) {
+        m_internals->NotifyInstantSendLock(islock);
+}
+
 void CMainSignals::NotifyChainLock(const CBlockIndex* pindex, const llmq::CChainLockSig& clsig) {
         m_internals->NotifyChainLock(pindex, clsig);
 }
 
+void CMainSignals::NotifyRecoveredSig(const llmq::CRecoveredSig& recoveredSig) {
+        m_internals->NotifyRecoveredSig(recoveredSig);
+}
+
 void CMainSignals::NotifyGovernanceVote(const CGovernanceVote &vote) {
         m_internals->NotifyGovernanceVote(vote);
 }
@@ -31,6 +31,16 @@ bool CZMQAbstractNotifier::NotifyTransactionLock(const CTransaction &/*transacti
     return true;
 }
 
+bool CZMQAbstractNotifier::NotifyInstantSendLock(const llmq::CInstantSendLock& /*islock*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyRecoveredSig(const llmq::CRecoveredSig& /*recoveredSig*/)
+{
+    return true;
+}
+
 bool CZMQAbstractNotifier::NotifyGovernanceVote(const CGovernanceVote& /*vote*/)
 {
     return true;
@@ -15,6 +15,7 @@ class CZMQAbstractNotifier;
 namespace llmq {
     class CChainLockSig;
     class CInstantSendLock;
+    class CRecoveredSig;
 } // namespace llmq
 
 typedef CZMQAbstractNotifier* (*CZMQNotifierFactory)();
@@ -43,6 +44,8 @@ public:
     virtual bool NotifyChainLock(const CBlockIndex *pindex, const llmq::CChainLockSig& clsig);
     virtual bool NotifyTransaction(const CTransaction &transaction);
     virtual bool NotifyTransactionLock(const CTransaction &transaction, const llmq::CInstantSendLock& islock);
+    virtual bool NotifyInstantSendLock(const llmq::CInstantSendLock& islock);
+    virtual bool NotifyRecoveredSig(const llmq::CRecoveredSig& recoveredSig);
     virtual bool NotifyGovernanceVote(const CGovernanceVote &vote);
     virtual bool NotifyGovernanceObject(const CGovernanceObject &object);
     virtual bool NotifyInstantSendDoubleSpendAttempt(const CTransaction &currentTx, const CTransaction &previousTx);
@@ -13,6 +13,9 @@
 class CBlockIndex;
 class CZMQAbstractNotifier;
 
+//! Default for -zmqpubhwm, the maximum number of messages queued for publishing
+static const int DEFAULT_ZMQ_PUB_HWM = 1000;
+
 class CZMQNotificationInterface : public CValidationInterface
 {
 public:
@@ -31,6 +34,8 @@ protected:
     void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
     void NotifyChainLock(const CBlockIndex *pindex, const llmq::CChainLockSig& clsig) override;
     void NotifyTransactionLock(const CTransaction &tx, const llmq::CInstantSendLock& islock) override;
+    void NotifyInstantSendLock(const llmq::CInstantSendLock& islock) override;
+    void NotifyRecoveredSig(const llmq::CRecoveredSig& recoveredSig) override;
     void NotifyGovernanceVote(const CGovernanceVote& vote) override;
     void NotifyGovernanceObject(const CGovernanceObject& object) override;
     void NotifyInstantSendDoubleSpendAttempt(const CTransaction &currentTx, const CTransaction &previousTx) override;
@@ -9,6 +9,12 @@
 #include "validation.h"
 #include "util.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
 static const char *MSG_HASHBLOCK     = "hashblock";
@@ -21,6 +27,9 @@ static const char *MSG_HASHISCON     = "hashinstantsenddoublespend";
 static const char *MSG_RAWBLOCK      = "rawblock";
 static const char *MSG_RAWCHAINLOCK  = "rawchainlock";
 static const char *MSG_RAWCLSIG      = "rawchainlocksig";
+static const char *MSG_RAWCLSIGONLY  = "rawclsig";
+static const char *MSG_RAWISLOCK     = "rawislock";
+static const char *MSG_RAWRECSIG     = "rawrecoveredsig";
 static const char *MSG_RAWTX         = "rawtx";
 static const char *MSG_RAWTXLOCK     = "rawtxlock";
 static const char *MSG_RAWTXLOCKSIG  = "rawtxlocksig";
@@ -71,6 +80,163 @@ static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
     return 0;
 }
 
+/** Upper bound for the memory used by queued messages, in addition to -zmqpubhwm */
+static const size_t MAX_QUEUED_BYTES = 128 * 1024 * 1024;
+
+/**
+ * Sends queued messages from a dedicated thread, so that notifying threads (validation, InstantSend, ChainLocks) never
+ * wait for ZMQ. The queue is bounded, messages which don't fit are dropped and counted. After Initialize, sockets are
+ * only used by the publisher thread.
+ */
+class CZMQPublisher
+{
+private:
+    struct Message {
+        const CZMQAbstractPublishNotifier* notifier;
+        void* psocket;
+        std::string command;
+        std::vector<unsigned char> data;
+        uint32_t nSequence;
+    };
+
+    const size_t maxMessages;
+
+    // Held while a message is sent, so that a socket can't be closed while it's in use. Must be locked before cs
+    std::mutex csSend;
+    std::mutex cs;
+    std::condition_variable cond;
+    std::deque<Message> queue;
+    size_t queuedBytes{0};
+    bool stopRequested{false};
+    uint64_t nDropped{0};
+    uint64_t nDroppedReported{0};
+    // Notifiers for which sending failed, reported back through HasSendFailed
+    std::set<const CZMQAbstractPublishNotifier*> failedNotifiers;
+
+    std::thread thread;
+
+public:
+    explicit CZMQPublisher(size_t _maxMessages) :
+        maxMessages(_maxMessages)
+    {
+        thread = std::thread(&CZMQPublisher::ThreadMain, this);
+    }
+
+    ~CZMQPublisher()
+    {
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            stopRequested = true;
+        }
+        cond.notify_one();
+        thread.join();
+        if (nDropped != 0) {
+            LogPrintf("zmq: %d messages were dropped because the publisher queue was full\n", nDropped);
+        }
+    }
+
+    size_t GetMaxMessages() const
+    {
+        return maxMessages;
+    }
+
+    void Push(const CZMQAbstractPublishNotifier* notifier, void* psocket, const char* command, const void* data, size_t size, uint32_t nSequence)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        if (queue.size() >= maxMessages || queuedBytes + size > MAX_QUEUED_BYTES) {
+            if (nDropped++ == nDroppedReported) {
+                LogPrintf("zmq: publisher queue full (%d messages, %d bytes), dropping messages\n", queue.size(), queuedBytes);
+            }
+            LogPrint(BCLog::ZMQ, "zmq: Dropped %s message %d\n", command, nSequence);
+            return;
+        }
+        const unsigned char* p = (const unsigned char*)data;
+        queue.emplace_back(Message{notifier, psocket, command, std::vector<unsigned char>(p, p + size), nSequence});
+        queuedBytes += size;
+        cond.notify_one();
+    }
+
+    /** Whether sending a message of the notifier failed since it was added */
+    bool HasSendFailed(const CZMQAbstractPublishNotifier* notifier)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        return failedNotifiers.count(notifier) != 0;
+    }
+
+    /** Discards all queued messages of the notifier and waits until none of them is being sent anymore */
+    void RemoveNotifier(const CZMQAbstractPublishNotifier* notifier)
+    {
+        std::unique_lock<std::mutex> sendLock(csSend);
+        std::unique_lock<std::mutex> lock(cs);
+        failedNotifiers.erase(notifier);
+        for (auto it = queue.begin(); it != queue.end(); ) {
+            if (it->notifier == notifier) {
+                queuedBytes -= it->data.size();
+                it = queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    void ThreadMain()
+    {
+        RenameThread("dash-zmqpub");
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(cs);
+                cond.wait(lock, [&]() { return stopRequested || !queue.empty(); });
+                if (queue.empty()) {
+                    // stop requested and all messages sent
+                    break;
+                }
+            }
+
+            std::unique_lock<std::mutex> sendLock(csSend);
+            Message msg;
+            {
+                std::unique_lock<std::mutex> lock(cs);
+                if (queue.empty()) {
+                    // RemoveNotifier discarded the messages in the meantime
+                    continue;
+                }
+                msg = std::move(queue.front());
+                queue.pop_front();
+                queuedBytes -= msg.data.size();
+                if (queue.empty() && nDropped != nDroppedReported) {
+                    LogPrintf("zmq: publisher queue drained, %d messages dropped in total\n", nDropped);
+                    nDroppedReported = nDropped;
+                }
+            }
+
+            /* send three parts, command & data & a LE 4byte sequence number */
+            unsigned char msgseq[sizeof(uint32_t)];
+            WriteLE32(&msgseq[0], msg.nSequence);
+            int rc = zmq_send_multipart(msg.psocket, msg.command.data(), msg.command.size(), msg.data.data(), msg.data.size(), msgseq, (size_t)sizeof(uint32_t), (void*)0);
+            if (rc == -1) {
+                LogPrint(BCLog::ZMQ, "zmq: Failed to send %s message %d\n", msg.command, msg.nSequence);
+                std::unique_lock<std::mutex> lock(cs);
+                failedNotifiers.emplace(msg.notifier);
+            }
+        }
+    }
+};
+
+static std::unique_ptr<CZMQPublisher> publisher;
+
+void CZMQAbstractPublishNotifier::StartPublisher(size_t maxMessages)
+{
+    assert(!publisher);
+    LogPrint(BCLog::ZMQ, "zmq: Starting publisher thread (hwm = %d)\n", maxMessages);
+    publisher.reset(new CZMQPublisher(maxMessages));
+}
+
+void CZMQAbstractPublishNotifier::StopPublisher()
+{
+    publisher.reset();
+}
+
 bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
 {
     assert(!psocket);
@@ -87,6 +253,10 @@ bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
             return false;
         }
 
+        assert(publisher);
+        int hwm = (int)publisher->GetMaxMessages();
+        zmq_setsockopt(psocket, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+
         int rc = zmq_bind(psocket, address.c_str());
         if (rc!=0)
         {
@@ -129,6 +299,10 @@ void CZMQAbstractPublishNotifier::Shutdown()
         }
     }
 
+    if (publisher) {
+        publisher->RemoveNotifier(this);
+    }
+
     if (count == 1)
     {
         LogPrint(BCLog::ZMQ, "Close socket at address %s\n", address);
@@ -143,16 +317,16 @@ void CZMQAbstractPublishNotifier::Shutdown()
 bool CZMQAbstractPublishNotifier::SendMessage(const char *command, const void* data, size_t size)
 {
     assert(psocket);
+    assert(publisher);
 
-    /* send three parts, command & data & a LE 4byte sequence number */
-    unsigned char msgseq[sizeof(uint32_t)];
-    WriteLE32(&msgseq[0], nSequence);
-    int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), (void*)0);
-    if (rc == -1)
+    // Sending happens asynchronously, so a failure is reported with the next message. The caller then shuts down
+    // this notifier
+    if (publisher->HasSendFailed(this)) {
         return false;
+    }
 
-    /* increment memory only sequence number after sending */
-    nSequence++;
+    /* the sequence number is incremented even if the message is dropped, so subscribers can detect the gap */
+    publisher->Push(this, psocket, command, data, size, nSequence++);
 
     return true;
 }
@@ -295,6 +469,30 @@ bool CZMQPublishRawChainLockSigNotifier::NotifyChainLock(const CBlockIndex *pind
     return SendMessage(MSG_RAWCLSIG, &(*ss.begin()), ss.size());
 }
 
+bool CZMQPublishRawCLSigNotifier::NotifyChainLock(const CBlockIndex *pindex, const llmq::CChainLockSig& clsig)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish rawclsig %s\n", clsig.blockHash.GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << clsig;
+    return SendMessage(MSG_RAWCLSIGONLY, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishRawISLockNotifier::NotifyInstantSendLock(const llmq::CInstantSendLock& islock)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish rawislock %s\n", islock.txid.GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << islock;
+    return SendMessage(MSG_RAWISLOCK, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishRawRecoveredSigNotifier::NotifyRecoveredSig(const llmq::CRecoveredSig& recoveredSig)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish rawrecoveredsig %s\n", recoveredSig.GetHash().GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << recoveredSig;
+    return SendMessage(MSG_RAWRECSIG, &(*ss.begin()), ss.size());
+}
+
 bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
 {
     uint256 hash = transaction.GetHash();
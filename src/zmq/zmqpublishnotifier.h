@@ -14,20 +14,26 @@ class CGovernanceObject;
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
 {
 private:
-    uint32_t nSequence; //!< upcounting per message sequence number
+    uint32_t nSequence{0}; //!< upcounting per message sequence number
 
 public:
 
-    /* send zmq multipart message
+    /* queue zmq multipart message for sending by the publisher thread
        parts:
           * command
           * data
           * message sequence number
+       If the queue is full, the message is dropped, which subscribers see as a gap in the sequence numbers
     */
     bool SendMessage(const char *command, const void* data, size_t size);
 
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
+
+    /** Start the publisher thread with a queue of at most maxMessages. Must be called before Initialize */
+    static void StartPublisher(size_t maxMessages);
+    /** Send all queued messages and stop the publisher thread */
+    static void StopPublisher();
 };
 
 class CZMQPublishHashBlockNotifier : public CZMQAbstractPublishNotifier
@@ -90,6 +96,24 @@ public:
     bool NotifyChainLock(const CBlockIndex *pindex, const llmq::CChainLockSig& clsig) override;
 };
 
+class CZMQPublishRawCLSigNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyChainLock(const CBlockIndex *pindex, const llmq::CChainLockSig& clsig) override;
+};
+
+class CZMQPublishRawISLockNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyInstantSendLock(const llmq::CInstantSendLock& islock) override;
+};
+
+class CZMQPublishRawRecoveredSigNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyRecoveredSig(const llmq::CRecoveredSig& recoveredSig) override;
+};
+
 class CZMQPublishRawTransactionNotifier : public CZMQAbstractPublishNotifier
 {
 public:
@@ -116,6 +116,22 @@ class AddressIndexTest(BitcoinTestFramework):
         assert_equal(multitxids[4], txid2)
         assert_equal(multitxids[5], txidb2)
 
+        # Check that paging through multiple addresses returns the same txids
+        self.log.info("Testing paging...")
+        pagedtxids = []
+        cursor = None
+        while True:
+            params = {"addresses": ["93bVhahvUKmQu8gu9g3QnPPa2cxFK98pMB", "yMNJePdcKvXtWWQnFYHNeJ5u8TF2v1dfK4"], "limit": 4}
+            if cursor is not None:
+                params["cursor"] = cursor
+            page = self.nodes[1].getaddresstxids(params)
+            assert(len(page["txids"]) <= 4)
+            pagedtxids += page["txids"]
+            cursor = page["next"]
+            if cursor is None:
+                break
+        assert_equal(pagedtxids, multitxids)
+
         # Check that balances are correct
         balance0 = self.nodes[1].getaddressbalance("93bVhahvUKmQu8gu9g3QnPPa2cxFK98pMB")
         assert_equal(balance0["balance"], 45 * 100000000)
@@ -339,8 +355,149 @@ class AddressIndexTest(BitcoinTestFramework):
         mempool_deltas = self.nodes[2].getaddressmempool({"addresses": [address1]})
         assert_equal(len(mempool_deltas), 2)
 
+        # Check that the balance index follows P2PK spends and reorgs
+        self.log.info("Testing balance index with P2PK outputs and reorgs...")
+        self.nodes[0].generate(1)
+        self.sync_all()
+
+        address5 = self.nodes[0].getnewaddress()
+        pubkey5 = hex_str_to_bytes(self.nodes[0].validateaddress(address5)["pubkey"])
+        scriptPubKey5 = CScript([pubkey5, OP_CHECKSIG])
+
+        unspent = self.nodes[0].listunspent()
+        tx = CTransaction()
+        tx.vin = [CTxIn(COutPoint(int(unspent[0]["txid"], 16), unspent[0]["vout"]))]
+        amount5 = int(unspent[0]["amount"] * 100000000) - tx_fee_sat
+        tx.vout = [CTxOut(amount5, scriptPubKey5)]
+        tx.rehash()
+        signed_tx = self.nodes[0].signrawtransaction(binascii.hexlify(tx.serialize()).decode("utf-8"))
+        p2pk_txid = self.nodes[0].sendrawtransaction(signed_tx["hex"], True)
+        p2pk_block = self.nodes[0].generate(1)[0]
+        self.sync_all()
+
+        # P2PK outputs are indexed under the P2PKH address of the pubkey
+        self.check_balance(address5, amount5, amount5)
+
+        tx = CTransaction()
+        tx.vin = [CTxIn(COutPoint(int(p2pk_txid, 16), 0))]
+        tx.vout = [CTxOut(amount5 - tx_fee_sat, scriptPubKey2)]
+        tx.rehash()
+        signed_tx = self.nodes[0].signrawtransaction(binascii.hexlify(tx.serialize()).decode("utf-8"))
+        assert(signed_tx["complete"])
+        self.nodes[0].sendrawtransaction(signed_tx["hex"], True)
+        spend_block = self.nodes[0].generate(1)[0]
+        self.sync_all()
+
+        self.check_balance(address5, 0, amount5)
+        balance_address2 = self.nodes[1].getaddressbalance(address2)
+
+        # Disconnect the spending block, the P2PK output is unspent again
+        for node in self.nodes:
+            node.invalidateblock(spend_block)
+        self.check_balance(address5, amount5, amount5)
+        assert_equal(self.nodes[1].getaddressbalance(address2)["balance"], balance_address2["balance"] - (amount5 - tx_fee_sat))
+
+        # Disconnect the funding block too, the address has no history left
+        for node in self.nodes:
+            node.invalidateblock(p2pk_block)
+        self.check_balance(address5, 0, 0)
+
+        # Reconnect both blocks
+        for node in self.nodes:
+            node.reconsiderblock(p2pk_block)
+        self.sync_all()
+        assert_equal(self.nodes[1].getbestblockhash(), spend_block)
+        self.check_balance(address5, 0, amount5)
+        assert_equal(self.nodes[1].getaddressbalance(address2), balance_address2)
+
+        # Check paging of deltas and utxos, with page boundaries in the middle of a block
+        self.log.info("Testing paging of deltas and utxos...")
+        # not part of the wallet of node 0, so that it never spends these outputs
+        address6 = self.nodes[1].getnewaddress()
+        for i in range(5):
+            self.nodes[0].sendtoaddress(address6, i + 1)
+        self.nodes[0].generate(1)
+        for i in range(2):
+            self.nodes[0].sendtoaddress(address6, i + 1)
+        self.nodes[0].generate(1)
+        self.sync_all()
+        height6 = self.nodes[1].getblockcount() - 1
+
+        deltas = self.nodes[1].getaddressdeltas({"addresses": [address6]})
+        assert_equal(len(deltas), 7)
+        first_page = self.nodes[1].getaddressdeltas({"addresses": [address6], "limit": 2})
+        assert_equal(first_page["deltas"], deltas[:2])
+        assert_equal(first_page["next"]["height"], height6)
+        assert_equal(first_page["next"]["blockindex"], deltas[2]["blockindex"])
+        assert_equal(self.get_deltas_paged(self.nodes[1], [address6], 2), deltas)
+        assert_equal(self.get_deltas_paged(self.nodes[1], [address6], 3), deltas)
+
+        # pages never split the deltas of a transaction, address2 has transactions with inputs and outputs
+        deltas = self.nodes[1].getaddressdeltas({"addresses": [address2, address6]})
+        deltas.sort(key=lambda delta: (delta["height"], delta["blockindex"]))
+        assert_equal(self.get_deltas_paged(self.nodes[1], [address2, address6], 2), deltas)
+        def delta_key(delta):
+            return (delta["height"], delta["blockindex"], delta["txid"], delta["address"], delta["index"], delta["satoshis"])
+        paged_deltas = self.get_deltas_paged(self.nodes[1], [address6, address2], 1)
+        assert_equal(sorted(paged_deltas, key=delta_key), sorted(deltas, key=delta_key))
+
+        def utxo_key(utxo):
+            return (utxo["txid"], utxo["outputIndex"])
+
+        utxos = self.nodes[1].getaddressutxos({"addresses": [address6]})
+        assert_equal(len(utxos), 7)
+        paged_utxos = self.get_utxos_paged(self.nodes[1], [address6], 2)
+        assert_equal(sorted(paged_utxos, key=utxo_key), sorted(utxos, key=utxo_key))
+
+        # the cursor continues with the next address once the outputs of an address are exhausted
+        utxos = self.nodes[1].getaddressutxos({"addresses": [address6, address2]})
+        paged_utxos = self.get_utxos_paged(self.nodes[1], [address6, address2], 3)
+        assert_equal(sorted(paged_utxos, key=utxo_key), sorted(utxos, key=utxo_key))
+        assert_equal(len(set(utxo_key(utxo) for utxo in paged_utxos)), len(paged_utxos))
+
         self.log.info("Passed")
 
+    def get_deltas_paged(self, node, addresses, limit):
+        deltas = []
+        cursor = None
+        while True:
+            params = {"addresses": addresses, "limit": limit}
+            if cursor is not None:
+                params["cursor"] = cursor
+            page = node.getaddressdeltas(params)
+            assert(len(set(delta["txid"] for delta in page["deltas"])) <= limit)
+            deltas += page["deltas"]
+            cursor = page["next"]
+            if cursor is None:
+                return deltas
+
+    def get_utxos_paged(self, node, addresses, limit):
+        utxos = []
+        cursor = None
+        while True:
+            params = {"addresses": addresses, "limit": limit}
+            if cursor is not None:
+                params["cursor"] = cursor
+            page = node.getaddressutxos(params)
+            assert(len(page["utxos"]) <= limit)
+            utxos += page["utxos"]
+            cursor = page["next"]
+            if cursor is None:
+                return utxos
+
+    def check_balance(self, address, balance, received):
+        # The balance index of the -addressindex nodes must match the sum of the address history
+        for node in self.nodes[1:]:
+            result = node.getaddressbalance(address)
+            assert_equal(result["balance"], balance)
+            assert_equal(result["received"], received)
+
+            deltas = node.getaddressdeltas({"addresses": [address]})
+            assert_equal(sum(delta["satoshis"] for delta in deltas), balance)
+            assert_equal(sum(delta["satoshis"] for delta in deltas if delta["satoshis"] > 0), received)
+            assert_equal(result["txcount"], len(set(delta["txid"] for delta in deltas)))
+            assert_equal(result["firstheight"], min(delta["height"] for delta in deltas) if deltas else -1)
+            assert_equal(result["lastheight"], max(delta["height"] for delta in deltas) if deltas else -1)
 
 if __name__ == '__main__':
     AddressIndexTest().main()
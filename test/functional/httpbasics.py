@@ -103,6 +103,17 @@ class HTTPBasicsTest (BitcoinTestFramework):
         out1 = conn.getresponse()
         assert_equal(out1.status, http.client.BAD_REQUEST)
 
+        # Check that requests are dispatched to the work queues of their method class
+        self.nodes[0].getblockcount()
+        self.nodes[0].gettxoutsetinfo()
+        queues = {q['name']: q for q in self.nodes[0].getrpcinfo()}
+        assert_equal(set(queues.keys()), {'fast', 'heavy', 'wallet'})
+        assert(queues['fast']['processed'] > 0)
+        assert(queues['heavy']['processed'] > 0)
+        for q in queues.values():
+            assert(q['threads'] > 0)
+            assert_equal(q['rejected'], 0)
+
 
 if __name__ == '__main__':
     HTTPBasicsTest ().main ()
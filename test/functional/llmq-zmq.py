@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+# Copyright (c) 2015-2020 The Dash Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+import configparser
+import os
+import struct
+from io import BytesIO
+
+from test_framework.mininode import *
+from test_framework.test_framework import DashTestFramework, SkipTest
+from test_framework.util import assert_equal, sync_blocks
+
+'''
+llmq-zmq.py
+
+Checks the rawrecoveredsig, rawclsig and rawislock ZMQ notifications
+
+'''
+
+ZMQ_ADDRESS = "tcp://127.0.0.1:28334"
+
+class LLMQZMQTest(DashTestFramework):
+    def set_test_params(self):
+        # Node 1 is the first masternode, it takes part in all signing sessions
+        extra_args = [[], ['-zmqpubrawrecoveredsig=%s' % ZMQ_ADDRESS, '-zmqpubrawclsig=%s' % ZMQ_ADDRESS,
+                           '-zmqpubrawislock=%s' % ZMQ_ADDRESS, '-zmqpubhwm=10000'], [], [], [], []]
+        self.set_dash_test_params(6, 5, extra_args, fast_dip3_enforcement=True)
+
+    def setup_network(self):
+        # Try to import python3-zmq. Skip this test if the import fails.
+        try:
+            import zmq
+        except ImportError:
+            raise SkipTest("python3-zmq module not available.")
+
+        # Check that dash has been built with ZMQ enabled
+        config = configparser.ConfigParser()
+        if not self.options.configfile:
+            self.options.configfile = os.path.dirname(__file__) + "/../config.ini"
+        config.read_file(open(self.options.configfile))
+
+        if not config["components"].getboolean("ENABLE_ZMQ"):
+            raise SkipTest("dashd has not been built with zmq enabled.")
+
+        self.zmqContext = zmq.Context()
+        self.zmqSubSocket = self.zmqContext.socket(zmq.SUB)
+        self.zmqSubSocket.set(zmq.RCVTIMEO, 60000)
+        self.zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"rawrecoveredsig")
+        self.zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"rawclsig")
+        self.zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"rawislock")
+        self.zmqSubSocket.connect(ZMQ_ADDRESS)
+
+        super().setup_network()
+
+    def run_test(self):
+        try:
+            self._zmq_test()
+        finally:
+            # Destroy the zmq context
+            self.log.debug("Destroying zmq context")
+            self.zmqContext.destroy(linger=None)
+
+    def wait_for_zmq(self, topic, check):
+        # Other notifications (e.g. recovered sigs of the ChainLocks signing sessions) may arrive in between
+        while True:
+            msg = self.zmqSubSocket.recv_multipart()
+            msgSequence = struct.unpack('<I', msg[-1])[-1]
+            if msg[0] == topic:
+                assert_equal(msgSequence, self.zmqSequences.get(topic, 0))
+            self.zmqSequences[msg[0]] = msgSequence + 1
+            if msg[0] == topic and check(BytesIO(msg[1])):
+                return
+
+    def _zmq_test(self):
+        self.zmqSequences = {}
+
+        while self.nodes[0].getblockchaininfo()["bip9_softforks"]["dip0008"]["status"] != "active":
+            self.nodes[0].generate(10)
+        sync_blocks(self.nodes, timeout=60*5)
+
+        self.nodes[0].spork("SPORK_17_QUORUM_DKG_ENABLED", 0)
+        self.wait_for_sporks_same()
+
+        self.mine_quorum()
+
+        self.log.info("Sign a message, wait for rawrecoveredsig")
+        id = "0000000000000000000000000000000000000000000000000000000000000001"
+        msgHash = "0000000000000000000000000000000000000000000000000000000000000002"
+        for i in range(3):
+            self.mninfo[i].node.quorum("sign", 100, id, msgHash)
+
+        def check_recoveredsig(f):
+            llmqType = struct.unpack('<B', f.read(1))[0]
+            deser_uint256(f) # quorumHash
+            sigId = deser_uint256(f)
+            sigMsgHash = deser_uint256(f)
+            return llmqType == 100 and sigId == int(id, 16) and sigMsgHash == int(msgHash, 16) and len(f.read()) == 96
+        self.wait_for_zmq(b"rawrecoveredsig", check_recoveredsig)
+
+        self.nodes[0].spork("SPORK_19_CHAINLOCKS_ENABLED", 0)
+        self.nodes[0].spork("SPORK_2_INSTANTSEND_ENABLED", 0)
+        self.wait_for_sporks_same()
+
+        self.log.info("Mine a block, wait for rawclsig")
+        block = self.nodes[0].generate(1)[0]
+        self.wait_for_chainlocked_block(self.nodes[1], block)
+
+        def check_clsig(f):
+            clsig = msg_clsig()
+            clsig.deserialize(f)
+            return clsig.blockHash == int(block, 16) and clsig.height == self.nodes[1].getblockcount()
+        self.wait_for_zmq(b"rawclsig", check_clsig)
+
+        self.log.info("Send a transaction, wait for rawislock")
+        txid = self.nodes[0].sendtoaddress(self.nodes[0].getnewaddress(), 1)
+        self.wait_for_instantlock(txid, self.nodes[1])
+
+        def check_islock(f):
+            islock = msg_islock()
+            islock.deserialize(f)
+            return islock.txid == int(txid, 16) and len(islock.inputs) > 0
+        self.wait_for_zmq(b"rawislock", check_islock)
+
+if __name__ == '__main__':
+    LLMQZMQTest().main()
@@ -322,5 +322,27 @@ class RESTTest (BitcoinTestFramework):
         json_obj = json.loads(json_string)
         assert_equal(json_obj['bestblockhash'], bb_hash)
 
+        # Dash specific endpoints
+        json_string = http_get_call(url.hostname, url.port, '/rest/mnlist/'+bb_hash+self.FORMAT_SEPARATOR+'json')
+        json_obj = json.loads(json_string)
+        assert_equal(json_obj['blockHash'], bb_hash)
+        assert_equal(json_obj['height'], self.nodes[0].getblockcount())
+        assert_equal(json_obj['mns'], [])
+
+        # block hash, height, total registered count and an empty vector of masternodes
+        response = http_get_call(url.hostname, url.port, '/rest/mnlist/'+bb_hash+self.FORMAT_SEPARATOR+'bin', True)
+        assert_equal(response.status, 200)
+        assert_equal(len(response.read()), 32 + 4 + 4 + 1)
+
+        json_string = http_get_call(url.hostname, url.port, '/rest/quorums/100'+self.FORMAT_SEPARATOR+'json')
+        assert_equal(json.loads(json_string), [])
+        response = http_get_call(url.hostname, url.port, '/rest/quorums/42'+self.FORMAT_SEPARATOR+'json', True)
+        assert_equal(response.status, 400)
+
+        response = http_get_call(url.hostname, url.port, '/rest/islock/'+bb_hash+self.FORMAT_SEPARATOR+'hex', True)
+        assert_equal(response.status, 404)
+        response = http_get_call(url.hostname, url.port, '/rest/chainlock'+self.FORMAT_SEPARATOR+'json', True)
+        assert_equal(response.status, 404)
+
 if __name__ == '__main__':
     RESTTest ().main ()
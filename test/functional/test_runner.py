@@ -74,6 +74,7 @@ BASE_SCRIPTS= [
     'llmq-is-cl-conflicts.py', # NOTE: needs dash_hash to pass
     'llmq-is-retroactive.py', # NOTE: needs dash_hash to pass
     'llmq-dkgerrors.py', # NOTE: needs dash_hash to pass
+    'llmq-zmq.py', # NOTE: needs dash_hash to pass
     'dip4-coinbasemerkleroots.py', # NOTE: needs dash_hash to pass
     # vv Tests less than 60s vv
     'sendheaders.py', # NOTE: needs dash_hash to pass
@@ -6,6 +6,7 @@
 import configparser
 import os
 import struct
+import time
 
 from codecs import encode
 
@@ -39,6 +40,7 @@ class ZMQTest (BitcoinTestFramework):
         if not config["components"].getboolean("ENABLE_ZMQ"):
             raise SkipTest("dashd has not been built with zmq enabled.")
 
+        self.zmq = zmq
         self.zmqContext = zmq.Context()
         self.zmqSubSocket = self.zmqContext.socket(zmq.SUB)
         self.zmqSubSocket.set(zmq.RCVTIMEO, 60000)
@@ -155,5 +157,32 @@ class ZMQTest (BitcoinTestFramework):
         assert_equal(hashRPC, hashZMQ)  # txid from sendtoaddress must be equal to the hash received over zmq
         assert_equal(hashRPC, hashedZMQ)
 
+        self.log.info("Restart node with -zmqpubhwm=1, messages which don't fit into the queue are dropped")
+        self.stop_node(0)
+        self.start_node(0, self.extra_args[0] + ['-zmqpubhwm=1'])
+        # give the subscriber time to reconnect
+        time.sleep(1)
+        genhashes = self.nodes[0].generate(n)
+
+        # sequence numbers start at 0 again and also count dropped messages, so there are gaps but no duplicates
+        self.zmqSubSocket.set(self.zmq.RCVTIMEO, 5000)
+        lastSequences = {}
+        received = 0
+        while True:
+            try:
+                msg = self.zmqSubSocket.recv_multipart()
+            except self.zmq.Again:
+                break
+            topic = msg[0]
+            msgSequence = struct.unpack('<I', msg[-1])[-1]
+            assert(msgSequence < n)
+            assert(msgSequence > lastSequences.get(topic, -1))
+            lastSequences[topic] = msgSequence
+            if topic == b"hashblock":
+                assert_equal(bytes_to_hex_str(msg[1]), genhashes[msgSequence])
+            received += 1
+        assert(received > 0)
+        assert(received <= n * 4)
+
 if __name__ == '__main__':
     ZMQTest().main()